@@ -0,0 +1,98 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AssetLoader
+ * @brief Wczytywanie zasobów w tle z przesyłaniem na GPU w wątku głównym.
+ *
+ * Zadanie składa się z dwóch części. Część robocza (odczyt pliku, import modelu,
+ * dekodowanie obrazu) wykonywana jest w wątku roboczym i zwraca zakończenie - funkcję
+ * tworzącą obiekty OpenGL z gotowych buforów CPU. Zakończenia trafiają do kolejki
+ * bez blokad (wielu producentów, jeden konsument), którą pętla główna opróżnia w pump()
+ * w granicach budżetu czasu na klatkę.
+ *
+ * Wszystkie wywołania poza częścią roboczą zadań muszą pochodzić z wątku głównego.
+ */
+class AssetLoader {
+public:
+    /**
+     * @brief Część zadania wykonywana w wątku głównym, z aktywnym kontekstem OpenGL.
+     */
+    using Completion = std::function<void()>;
+
+    /**
+     * @brief Część zadania wykonywana w wątku roboczym; może zwrócić puste zakończenie.
+     */
+    using Job = std::function<Completion()>;
+
+    /**
+     * @brief Uruchamia wątki robocze.
+     *
+     * @param threadCount Liczba wątków (0 - o jeden mniej niż rdzeni, co najmniej jeden).
+     */
+    explicit AssetLoader(unsigned int threadCount = 0);
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief Zatrzymuje wątki; zadania, które nie zdążyły się wykonać, są porzucane.
+     */
+    ~AssetLoader();
+
+    /**
+     * @brief Zleca zadanie wątkom roboczym.
+     */
+    void enqueue(Job job);
+
+    /**
+     * @brief Wykonuje gotowe zakończenia, dopóki nie minie budżet czasu.
+     *
+     * Budżet sprawdzany jest między zakończeniami, więc co najmniej jedno jest
+     * wykonywane zawsze, gdy kolejka nie jest pusta.
+     *
+     * @param budgetMs Budżet czasu w milisekundach.
+     * @return true, gdy nie ma już zadań w toku.
+     */
+    bool pump(double budgetMs);
+
+    /**
+     * @brief Liczba zadań, których zakończenie nie zostało jeszcze wykonane.
+     */
+    size_t pendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @struct Node
+     * @brief Węzeł kolejki zakończeń.
+     */
+    struct Node {
+        std::atomic<Node*> next{ nullptr };  /**< Następny węzeł (ustawiany przez producenta). */
+        Completion completion;               /**< Zakończenie zadania (może być puste). */
+    };
+
+    void workerLoop();
+    void push(Node* node);
+    Node* pop();
+
+    std::vector<std::thread> workers;       /**< Wątki robocze. */
+    std::deque<Job> jobs;                    /**< Zadania oczekujące na wątek roboczy. */
+    std::mutex jobMutex;                     /**< Chroni jobs i stopping. */
+    std::condition_variable jobAvailable;    /**< Budzi wątki robocze. */
+    bool stopping = false;                   /**< Czy wątki mają się zakończyć. */
+
+    std::atomic<Node*> head;                 /**< Ostatnio dodany węzeł (strona producentów). */
+    Node* tail;                              /**< Najstarszy węzeł (strona konsumenta). */
+    Node stub;                               /**< Węzeł wartownika pustej kolejki. */
+    std::atomic<size_t> pending{ 0 };        /**< Zadania bez wykonanego zakończenia. */
+};
+
+#endif // ASSETLOADER_H
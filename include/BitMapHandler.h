@@ -4,8 +4,26 @@
 #include <GL/glew.h>
 #include <iostream>
 #include <GL/freeglut.h>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+
+class AssetLoader;
+class PixelUploadRing;
+struct TextureSource;
+
+/**
+ * @struct TextureCacheStats
+ * @brief Liczniki pamięci podręcznej tekstur wczytywanych z plików.
+ */
+struct TextureCacheStats {
+    size_t hits = 0;              /**< Liczba wczytań obsłużonych z pamięci podręcznej. */
+    size_t misses = 0;            /**< Liczba wczytań wymagających dekodowania pliku. */
+    size_t residentTextures = 0;  /**< Liczba tekstur aktualnie obecnych w pamięci. */
+    size_t residentBytes = 0;     /**< Szacowany rozmiar tekstur w VRAM (z mipmapami). */
+};
 
 /**
  * @class BitmapHandler
@@ -21,13 +39,59 @@ public:
      * @brief Ładuje bitmapę z pliku i tworzy teksturę OpenGL.
      *
      * Funkcja wczytuje plik bitmapy o podanej nazwie i generuje odpowiadającą
-     * jej teksturę OpenGL.
+     * jej teksturę OpenGL. Tekstury są współdzielone: ponowne wczytanie tej samej
+     * ścieżki zwraca istniejący identyfikator i zwiększa licznik referencji.
+     * Każde udane wywołanie należy zrównoważyć wywołaniem releaseBitmap().
+     *
+     * Jeśli obok pliku leży aktualny plik .dds (CookedTexture, tworzony narzędziem
+     * TextureCooker), na GPU trafiają z niego skompresowane bloki BC1/BC3 z mipmapami.
+     *
+     * Gdy ustawiony jest program ładujący (setLoader), funkcja od razu zwraca
+     * identyfikator tekstury zastępczej 1x1, a plik dekodowany jest w wątku roboczym.
+     * Obraz trafia do tej samej tekstury w AssetLoader::pump() - albo, gdy ustawiony
+     * jest pierścień przesyłania (setUploadRing), stopniowo w streamUploads() - więc
+     * identyfikator zapamiętany przez ściany i siatki pozostaje ważny.
      *
      * @param filename Ścieżka do pliku bitmapy.
      * @return Identyfikator tekstury OpenGL lub 0 w przypadku błędu.
      */
     static GLuint loadBitmapFromFile(const std::string& filename);
 
+    /**
+     * @brief Ustawia program ładujący dla kolejnych wczytań (nullptr - wczytywanie blokujące).
+     */
+    static void setLoader(AssetLoader* assetLoader);
+
+    /**
+     * @brief Ustawia pierścień, przez który przesyłane są tekstury wczytane w tle (nullptr - przesyłanie od razu).
+     */
+    static void setUploadRing(PixelUploadRing* ring);
+
+    /**
+     * @brief Przesyła oczekujące tekstury przez pierścień, nie więcej niż budgetBytes na wywołanie.
+     *
+     * Poziomy mipmap przesyłane są od najmniejszego, a GL_TEXTURE_BASE_LEVEL obniżany jest
+     * po każdym z nich, więc tekstura jest poprawna po każdym kroku. Przynajmniej jeden
+     * poziom przesyłany jest zawsze, o ile pierścień ma wolne miejsce. Wołać raz na klatkę.
+     *
+     * @param budgetBytes Limit bajtów tekseli na wywołanie.
+     */
+    static void streamUploads(size_t budgetBytes);
+
+    /**
+     * @brief Zwalnia referencję do tekstury wczytanej przez loadBitmapFromFile().
+     *
+     * Tekstura jest usuwana z GPU, gdy zostanie zwolniona ostatnia referencja.
+     *
+     * @param textureID Identyfikator tekstury OpenGL.
+     */
+    static void releaseBitmap(GLuint textureID);
+
+    /**
+     * @brief Zwraca liczniki pamięci podręcznej tekstur.
+     */
+    static TextureCacheStats getCacheStats();
+
     /**
      * @brief Tworzy jednolitą bitmapę o podanym kolorze i rozmiarze.
      *
@@ -66,6 +130,47 @@ public:
      * @param height Wysokość kopiowanego obszaru.
      */
     static void copyBitmap(GLuint sourceTextureID, GLuint destinationTextureID, int x, int y, int width, int height);
+
+private:
+    /**
+     * @struct CacheEntry
+     * @brief Wpis pamięci podręcznej tekstur.
+     */
+    struct CacheEntry {
+        GLuint textureID = 0;  /**< Identyfikator tekstury OpenGL. */
+        int refCount = 0;      /**< Liczba aktywnych referencji. */
+        size_t bytes = 0;      /**< Szacowany rozmiar tekstury w VRAM. */
+    };
+
+    /**
+     * @struct PendingUpload
+     * @brief Tekstura wczytana w tle, czekająca na przesłanie przez PixelUploadRing.
+     */
+    struct PendingUpload {
+        std::string key;                        /**< Klucz wpisu w pamięci podręcznej. */
+        GLuint textureID = 0;                   /**< Tekstura zastępcza, do której trafia obraz. */
+        std::string filename;                   /**< Ścieżka pliku (do komunikatu po wczytaniu). */
+        std::shared_ptr<TextureSource> source;  /**< Zdekodowane lub skompresowane poziomy mipmap. */
+        int nextLevel = 0;                      /**< Następny poziom do przesłania (od najmniejszego). */
+        bool started = false;                   /**< Czy magazyn tekstury został już utworzony. */
+    };
+
+    /**
+     * @brief Dekoduje plik i tworzy nową teksturę z pominięciem pamięci podręcznej.
+     */
+    static GLuint uploadBitmapFromFile(const std::string& filename, size_t& bytes);
+
+    /**
+     * @brief Tworzy teksturę zastępczą i zleca dekodowanie pliku programowi ładującemu.
+     */
+    static GLuint loadBitmapAsync(const std::string& filename, const std::string& key, size_t& bytes);
+
+    static std::unordered_map<std::string, CacheEntry> cache;    /**< Wpisy według kanonicznej ścieżki. */
+    static std::unordered_map<GLuint, std::string> cacheKeys;   /**< Ścieżka wpisu według identyfikatora tekstury. */
+    static TextureCacheStats stats;                             /**< Liczniki pamięci podręcznej. */
+    static AssetLoader* loader;                                 /**< Program ładujący (nullptr - wczytywanie blokujące). */
+    static PixelUploadRing* uploadRing;                         /**< Pierścień przesyłania (nullptr - przesyłanie od razu). */
+    static std::deque<PendingUpload> pendingUploads;            /**< Tekstury czekające na przesłanie, od najstarszej. */
 };
 
 #endif // BITMAPHANDLER_H
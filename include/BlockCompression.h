@@ -0,0 +1,60 @@
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Format bloków kompresji tekstur.
+ */
+enum class BlockFormat {
+    BC1,  /**< RGB, 8 bajtów na blok 4x4 (DXT1). */
+    BC3   /**< RGBA, 16 bajtów na blok 4x4 (DXT5): alfa interpolowana + kolor BC1. */
+};
+
+/**
+ * @class BlockCompression
+ * @brief Koder bloków BC1/BC3 używany przy przetwarzaniu tekstur.
+ *
+ * Końce odcinka kolorów wyznaczane są wzdłuż głównej osi rozrzutu kolorów bloku
+ * (iteracja potęgowa na macierzy kowariancji), każdy piksel dostaje najbliższy kolor
+ * palety. Jakość odpowiada szybkim koderom typu stb_dxt - wystarcza dla tekstur
+ * diffuse, a koder nie wywołuje OpenGL i może działać w narzędziach.
+ */
+class BlockCompression {
+public:
+    /**
+     * @brief Rozmiar bloku 4x4 w bajtach.
+     */
+    static size_t blockBytes(BlockFormat format) { return format == BlockFormat::BC1 ? 8 : 16; }
+
+    /**
+     * @brief Rozmiar skompresowanego obrazu w bajtach.
+     */
+    static size_t imageBytes(BlockFormat format, int width, int height);
+
+    /**
+     * @brief Koduje jeden blok.
+     *
+     * @param rgba 16 pikseli RGBA, wiersz po wierszu.
+     * @param format Format bloku.
+     * @param out blockBytes(format) bajtów wyniku.
+     */
+    static void encodeBlock(const uint8_t rgba[64], BlockFormat format, uint8_t* out);
+
+    /**
+     * @brief Kompresuje obraz 8-bitowy; niepełne bloki na krawędziach powielają skrajne piksele.
+     *
+     * @param pixels Piksele obrazu, wiersz po wierszu, bez wyrównania wierszy.
+     * @param width Szerokość obrazu.
+     * @param height Wysokość obrazu.
+     * @param channels Liczba kanałów (1 - jasność, 2 - jasność z alfą, 3 - RGB, 4 - RGBA).
+     * @param format Format wyniku.
+     * @param out Bloki wiersz po wierszu; dopisywane na końcu wektora.
+     */
+    static void compress(const unsigned char* pixels, int width, int height, int channels, BlockFormat format,
+        std::vector<uint8_t>& out);
+};
+
+#endif // BLOCKCOMPRESSION_H
@@ -0,0 +1,63 @@
+#ifndef COOKEDMESH_H
+#define COOKEDMESH_H
+
+#include "MeshCache.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class CookedMesh
+ * @brief Binarny format modelu z buforami gotowymi do przesłania na GPU.
+ *
+ * Plik zawiera nagłówek (wersja formatu, flagi importu, układ wierzchołków, AABB),
+ * opisy siatek (kwantyzacja, poziomy szczegółowości, ścieżka tekstury) oraz zawartość
+ * VBO i EBO każdej siatki wyrównaną do 16 bajtów. Wczytanie sprowadza się do zmapowania
+ * pliku i sprawdzenia zakresów - bufory trafiają do glBufferData prosto z mapowania.
+ *
+ * Pliki tworzy narzędzie MeshCooker; plik o innej wersji, z innymi flagami importu albo
+ * innym układem wierzchołków jest odrzucany i model importowany jest ze źródła.
+ */
+class CookedMesh {
+public:
+    /**
+     * @brief Wersja formatu; zmiana układu pliku albo przetwarzania siatek wymaga jej podbicia.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Ścieżka pliku przetworzonego dla pliku źródłowego (rozszerzenie .mesh).
+     */
+    static std::string pathFor(const std::string& sourcePath);
+
+    /**
+     * @brief Sprawdza, czy plik przetworzony istnieje i nie jest starszy od źródła.
+     *
+     * Brak pliku źródłowego nie unieważnia pliku przetworzonego.
+     */
+    static bool isFresh(const std::string& cookedPath, const std::string& sourcePath);
+
+    /**
+     * @brief Zapisuje zaimportowany model (bez wywołań OpenGL).
+     *
+     * Plik zapisywany jest pod nazwą tymczasową i dopiero potem podmieniany.
+     *
+     * @param path Ścieżka pliku wynikowego.
+     * @param model Zaimportowany model.
+     * @param importFlags Flagi importu, z którymi wczytano model.
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool write(const std::string& path, const CpuModel& model, unsigned int importFlags);
+
+    /**
+     * @brief Odczytuje model ze zmapowanego pliku.
+     *
+     * @param file Zmapowany plik; musi pozostać otwarty, dopóki out jest używany.
+     * @param importFlags Oczekiwane flagi importu.
+     * @param out Opis modelu wskazujący na dane w mapowaniu.
+     * @return true, jeśli plik jest poprawny i zgodny z bieżącą konfiguracją.
+     */
+    static bool read(const MappedFile& file, unsigned int importFlags, ModelBlob& out);
+};
+
+#endif // COOKEDMESH_H
@@ -0,0 +1,80 @@
+#ifndef COOKEDTEXTURE_H
+#define COOKEDTEXTURE_H
+
+#include "BlockCompression.h"
+#include "MappedFile.h"
+#include "MipChain.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CompressedTexture
+ * @brief Skompresowana tekstura z pełnym łańcuchem mipmap, wskazująca na zmapowany plik.
+ */
+struct CompressedTexture {
+    GLenum format = 0;                   /**< GL_COMPRESSED_RGB_S3TC_DXT1_EXT lub GL_COMPRESSED_RGBA_S3TC_DXT5_EXT. */
+    const unsigned char* data = nullptr; /**< Początek danych pierwszego poziomu. */
+    std::vector<MipLevel> levels;        /**< Poziomy; przesunięcia liczone od data. */
+};
+
+/**
+ * @class CookedTexture
+ * @brief Tekstury skompresowane blokowo (BC1/BC3) w plikach DDS.
+ *
+ * Plik to standardowy DDS (FourCC DXT1 lub DXT5) z kompletem mipmap. Wiersze bloków
+ * zapisane są w kolejności OpenGL - od dołu obrazu, tak jak zwraca je stb_image
+ * z odwróceniem w pionie - więc dane trafiają na GPU bez przekształceń. Dlatego
+ * odczytywane są tylko pliki oznaczone w polu zarezerwowanym nagłówka sygnaturą
+ * i wersją tego formatu; pozostałe pliki DDS są odrzucane.
+ *
+ * Pliki tworzy narzędzie TextureCooker; BitmapHandler wczytuje je zamiast źródła,
+ * jeśli nie są starsze od niego.
+ */
+class CookedTexture {
+public:
+    /**
+     * @brief Wersja formatu; zmiana kodera lub filtrowania mipmap wymaga jej podbicia.
+     */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Ścieżka pliku przetworzonego dla pliku źródłowego (rozszerzenie .dds).
+     */
+    static std::string pathFor(const std::string& sourcePath);
+
+    /**
+     * @brief Sprawdza, czy plik przetworzony istnieje i nie jest starszy od źródła.
+     *
+     * Brak pliku źródłowego nie unieważnia pliku przetworzonego.
+     */
+    static bool isFresh(const std::string& cookedPath, const std::string& sourcePath);
+
+    /**
+     * @brief Format bloków dla obrazu o danej liczbie kanałów (BC3 tylko z kanałem alfa).
+     */
+    static BlockFormat formatFor(int channels) { return channels == 2 || channels == 4 ? BlockFormat::BC3 : BlockFormat::BC1; }
+
+    /**
+     * @brief Kompresuje łańcuch mipmap i zapisuje go (bez wywołań OpenGL).
+     *
+     * Plik zapisywany jest pod nazwą tymczasową i dopiero potem podmieniany.
+     *
+     * @param path Ścieżka pliku wynikowego.
+     * @param chain Łańcuch mipmap obrazu (wiersze od dołu).
+     * @return true, jeśli zapis się powiódł.
+     */
+    static bool write(const std::string& path, const MipChain& chain);
+
+    /**
+     * @brief Odczytuje teksturę ze zmapowanego pliku.
+     *
+     * @param file Zmapowany plik; musi pozostać otwarty, dopóki out jest używany.
+     * @param out Opis tekstury wskazujący na dane w mapowaniu.
+     * @return true, jeśli plik jest poprawny i zapisany przez tę wersję formatu.
+     */
+    static bool read(const MappedFile& file, CompressedTexture& out);
+};
+
+#endif // COOKEDTEXTURE_H
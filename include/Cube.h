@@ -52,14 +52,21 @@ public:
     void setupBuffers();
 
     /**
-     * @brief Rysuje sześcian przy użyciu podanego programu cieniującego i macierzy transformacji.
+     * @brief Zgłasza sześcian do kolejki rysowania w podanym przebiegu.
      *
-     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param queue Kolejka rysowania bieżącej klatki.
+     * @param pass Przebieg, w którym obiekt ma zostać narysowany.
+     * @param shader Program cieniujący z rozwiązanymi uchwytami uniformów.
      * @param model Macierz modelu, określająca transformację obiektu w przestrzeni świata.
-     * @param view Macierz widoku, określająca pozycję kamery i jej orientację.
-     * @param projection Macierz projekcji, definiująca sposób odwzorowania 3D na 2D.
      */
-    void draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) override;
+    void submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const override;
+
+    /**
+     * @brief Zwraca sferę otaczającą (wierzchołki są już w przestrzeni świata).
+     *
+     * Wyznaczana ponownie tylko po transformacji.
+     */
+    BoundingSphere getBoundingSphere() const override;
 
     /**
      * @brief Przesuwa sześcian o podany wektor kierunku.
@@ -129,6 +136,16 @@ private:
      * @brief Tablica przechowująca identyfikatory tekstur dla każdej ściany sześcianu.
      */
     std::array<GLuint, 6> textures = { 0, 0, 0, 0, 0, 0 };
+
+    /**
+     * @brief Sfera otaczająca, wyznaczana leniwie po zmianie wierzchołków.
+     */
+    mutable BoundingSphere bounds;
+
+    /**
+     * @brief Sfera otaczająca wymaga ponownego wyznaczenia.
+     */
+    mutable bool boundsDirty = true;
 };
 
 #endif // CUBE_H
@@ -2,6 +2,9 @@
 #define DRAWABLEOBJECT_H
 
 #include "GameObject.h"
+#include "Shader.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -27,18 +30,28 @@ public:
 
 
     /**
-     * @brief Rysuje obiekt przy użyciu podanego programu cieniującego i macierzy transformacji.
+     * @brief Zgłasza obiekt do kolejki rysowania w podanym przebiegu.
      *
-     * Ta metoda powinna być nadpisana w klasach pochodnych, aby umożliwić renderowanie
-     * specyficznych obiektów w scenie. Wykorzystuje program cieniujący oraz przekazane
-     * macierze modelu, widoku i projekcji do prawidłowego rysowania obiektu w przestrzeni 3D.
+     * Ta metoda powinna być nadpisana w klasach pochodnych. Zamiast rysować bezpośrednio,
+     * obiekt tworzy pakiety rysowania (po jednym na siatkę), które kolejka sortuje
+     * i wykonuje; macierze widoku i projekcji pochodzą z bloku FrameData.
      *
-     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param queue Kolejka rysowania bieżącej klatki.
+     * @param pass Przebieg, w którym obiekt ma zostać narysowany.
+     * @param shader Program cieniujący z rozwiązanymi uchwytami uniformów.
      * @param model Macierz modelu, określająca transformację obiektu w przestrzeni świata.
-     * @param view Macierz widoku, określająca pozycję kamery i jej orientację.
-     * @param projection Macierz projekcji, definiująca sposób odwzorowania 3D na 2D.
      */
-    virtual void draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) = 0;
+    virtual void submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const = 0;
+
+    /**
+     * @brief Zwraca sferę otaczającą obiekt w przestrzeni, w której podawana jest macierz modelu do submit().
+     *
+     * Używana do odrzucania obiektów poza ostrosłupem widzenia. Domyślnie obiekt nie ma
+     * znanych granic i nigdy nie jest odrzucany.
+     *
+     * @return Sfera otaczająca przed przekształceniem macierzą modelu.
+     */
+    virtual BoundingSphere getBoundingSphere() const { return BoundingSphere(); }
 };
 
 #endif // DRAWABLEOBJECT_H
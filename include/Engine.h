@@ -11,7 +11,13 @@
 #include <glm/gtx/string_cast.hpp>
 #include <set>
 
+#include "AssetLoader.h"
+#include "PixelUploadRing.h"
 #include "Shader.h"
+#include "ShaderPermutations.h"
+#include "UniformBuffer.h"
+#include "StaticGeometry.h"
+#include "LightClusters.h"
 
 #include "Observer.h"
 #include "Cube.h"
@@ -26,16 +32,25 @@
  * @struct Light
  * @brief Struktura reprezentująca źródło światła w scenie.
  *
- * Przechowuje pozycję, kolor oraz mapę cieni potrzebną do obliczania efektów oświetlenia.
+ * Przechowuje pozycję, kolor oraz macierz przestrzeni światła. Mapa cieni światła to
+ * warstwa o tym samym indeksie we wspólnej tablicy map cieni silnika.
  */
 struct Light {
     glm::vec3 position;      /**< Pozycja światła w przestrzeni 3D. */
     glm::vec3 color;         /**< Kolor światła. */
-    GLuint shadowFBO;        /**< Identyfikator FBO dla shadow mappingu. */
-    GLuint shadowMap;        /**< Identyfikator tekstury cieni. */
+    float range;             /**< Zasięg światła używany przy przypisywaniu do klastrów. */
     glm::mat4 lightSpaceMatrix; /**< Macierz przestrzeni światła do rzutowania cieni. */
 };
 
+/**
+ * @struct TransientLight
+ * @brief Krótkotrwałe światło bez cienia (np. błysk wystrzału).
+ */
+struct TransientLight {
+    PointLight light;        /**< Parametry światła. */
+    float timeLeft;          /**< Pozostały czas życia w sekundach. */
+};
+
 /**
  * @class Engine
  * @brief Klasa głównego silnika renderującego.
@@ -111,6 +126,44 @@ private:
      */
     void initSettings();
 
+    /**
+     * @brief Wybiera permutacje głównego shadera dla bieżących ustawień.
+     *
+     * Liczba map cieni, tryb debugowania, przebieg (klastry lub wszystkie światła)
+     * i materiał (z teksturą lub bez) wybierają skompilowany wariant zamiast
+     * rozgałęzień sterowanych uniformami.
+     */
+    static void selectShaderPermutations();
+
+    /**
+     * @brief Buduje zestaw definicji głównego shadera dla bieżących ustawień.
+     *
+     * @param clustered Czy wariant korzysta z list świateł klastrów.
+     * @param textured Czy wariant próbkuje teksturę.
+     */
+    static ShaderDefines mainShaderDefines(bool clustered, bool textured);
+
+    /**
+     * @brief Tworzy tablicę tekstur głębokości (jedna warstwa na światło) i warstwowe FBO.
+     *
+     * @param fbo Zwracany identyfikator FBO.
+     * @param texture Zwracany identyfikator tekstury GL_TEXTURE_2D_ARRAY.
+     * @param layers Liczba warstw.
+     */
+    static void createShadowTarget(GLuint& fbo, GLuint& texture, GLsizei layers);
+
+    /**
+     * @brief Renderuje statyczną warstwę map cieni, jeśli została unieważniona.
+     */
+    static void updateStaticShadows();
+
+    /**
+     * @brief Pakuje ściany i wczytane już nieruchome modele do areny rysowanej przez multi-draw indirect.
+     *
+     * Wywoływana ponownie za każdym razem, gdy w tle dotrze kolejny nieruchomy model.
+     */
+    static void buildStaticGeometry();
+
     /**
      * @brief Funkcja renderowania sceny, wywoływana w pętli głównej.
      */
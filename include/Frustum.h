@@ -0,0 +1,83 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+/**
+ * @struct BoundingSphere
+ * @brief Sfera otaczająca obiekt, używana do odrzucania poza ostrosłupem widzenia.
+ *
+ * Ujemny promień oznacza obiekt bez znanych granic - taki obiekt nigdy nie jest odrzucany.
+ */
+struct BoundingSphere {
+    glm::vec3 center{ 0.0f };  /**< Środek sfery. */
+    float radius = -1.0f;      /**< Promień sfery (ujemny = brak granic). */
+
+    /**
+     * @brief Sprawdza, czy sfera opisuje rzeczywiste granice obiektu.
+     */
+    bool isValid() const { return radius >= 0.0f; }
+
+    /**
+     * @brief Przekształca sferę macierzą modelu (promień skalowany największą skalą osi).
+     */
+    BoundingSphere transformed(const glm::mat4& model) const;
+
+    /**
+     * @brief Tworzy sferę opisaną na prostopadłościanie.
+     */
+    static BoundingSphere fromBounds(const glm::vec3& min, const glm::vec3& max);
+
+    /**
+     * @brief Tworzy sferę z przeplatanych danych wierzchołków (pozycja na początku każdego wierzchołka).
+     *
+     * @param data Dane wierzchołków.
+     * @param floatCount Liczba elementów w tablicy.
+     * @param stride Liczba elementów na wierzchołek.
+     */
+    static BoundingSphere fromVertices(const float* data, size_t floatCount, size_t stride);
+};
+
+/**
+ * @struct CullingStats
+ * @brief Liczniki odrzucania obiektów w przebiegu głównym ostatniej klatki.
+ */
+struct CullingStats {
+    size_t visible = 0;  /**< Obiekty przekazane do rysowania. */
+    size_t culled = 0;   /**< Obiekty odrzucone poza ostrosłupem widzenia. */
+};
+
+/**
+ * @class Frustum
+ * @brief Ostrosłup widzenia kamery z testem sfer w SSE.
+ *
+ * Płaszczyzny przechowywane są w układzie SoA (osobne tablice x, y, z, w), więc test
+ * sfery sprawdza cztery płaszczyzny jedną instrukcją. Sześć płaszczyzn uzupełnionych
+ * jest do ośmiu kopiami dwóch pierwszych. Bez SSE używana jest wersja skalarna.
+ */
+class Frustum {
+public:
+    /**
+     * @brief Wyznacza płaszczyzny z macierzy projekcja * widok.
+     *
+     * @param viewProjection Iloczyn macierzy projekcji i widoku.
+     */
+    void update(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Sprawdza, czy sfera choć częściowo leży wewnątrz ostrosłupa.
+     *
+     * @param sphere Sfera w przestrzeni świata.
+     * @return false tylko wtedy, gdy sfera w całości leży poza jedną z płaszczyzn.
+     */
+    bool isVisible(const BoundingSphere& sphere) const;
+
+private:
+    alignas(16) float planeX[8] = {};  /**< Składowe x normalnych płaszczyzn. */
+    alignas(16) float planeY[8] = {};  /**< Składowe y normalnych płaszczyzn. */
+    alignas(16) float planeZ[8] = {};  /**< Składowe z normalnych płaszczyzn. */
+    alignas(16) float planeW[8] = {};  /**< Odległości płaszczyzn od początku układu. */
+};
+
+#endif // FRUSTUM_H
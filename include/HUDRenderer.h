@@ -27,6 +27,11 @@ private:
 
     GLuint quadVAO = 0, quadVBO = 0;
     Shader* hudShader = nullptr;
+    Shader::UniformHandle colorUniform = -1;
+    Shader::UniformHandle lineWidthUniform = -1;
+    Shader::UniformHandle gapSizeUniform = -1;
+    Shader::UniformHandle lengthUniform = -1;
+    Shader::UniformHandle resolutionUniform = -1;
 
     void loadCrosshairTexture(const std::string& path);
     void setupQuad();
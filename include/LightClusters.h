@@ -0,0 +1,138 @@
+#ifndef LIGHTCLUSTERS_H
+#define LIGHTCLUSTERS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Punkt wiązania bufora SSBO z listą wszystkich świateł punktowych.
+ */
+constexpr GLuint POINT_LIGHT_BINDING = 2;
+
+/**
+ * @brief Punkt wiązania bufora SSBO z zakresami list świateł klastrów.
+ */
+constexpr GLuint CLUSTER_GRID_BINDING = 3;
+
+/**
+ * @brief Punkt wiązania bufora SSBO z indeksami świateł klastrów.
+ */
+constexpr GLuint CLUSTER_INDEX_BINDING = 4;
+
+/**
+ * @struct PointLight
+ * @brief Światło punktowe w buforze SSBO, układ std430.
+ */
+struct PointLight {
+    glm::vec3 position;   /**< Pozycja światła w przestrzeni świata. */
+    float range;          /**< Zasięg, poza którym światło nie oświetla fragmentów. */
+    glm::vec3 color;      /**< Kolor (natężenie) światła. */
+    int shadowLayer;      /**< Warstwa tablicy map cieni (-1 = światło bez cienia). */
+};
+
+static_assert(sizeof(PointLight) == 32, "PointLight must match std430 layout");
+
+/**
+ * @class LightClusters
+ * @brief Klastrowe przypisanie świateł do fragmentów (clustered forward shading).
+ *
+ * Ostrosłup widzenia dzielony jest na siatkę klastrów: kafelki ekranu w osiach x i y
+ * oraz plastry głębokości rozłożone wykładniczo między bliską a daleką płaszczyzną.
+ * Co klatkę, na CPU, każde światło testowane jest (sfera zasięgu z prostopadłościanem
+ * klastra, cztery klastry jedną instrukcją SSE) tylko z plastrami, które obejmuje jego
+ * zasięg. Wynikowe listy trafiają do trzech buforów SSBO (światła, zakres listy każdego
+ * klastra, indeksy), a fragment shader cieniuje wyłącznie światła swojego klastra.
+ *
+ * Prostopadłościany klastrów liczone są ponownie tylko po zmianie projekcji.
+ */
+class LightClusters {
+public:
+    static constexpr uint32_t TILES_X = 16;  /**< Liczba kafelków w poziomie. */
+    static constexpr uint32_t TILES_Y = 9;   /**< Liczba kafelków w pionie. */
+    static constexpr uint32_t SLICES = 24;   /**< Liczba plastrów głębokości. */
+    static constexpr uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * SLICES; /**< Liczba klastrów. */
+
+    /**
+     * @brief Przypisuje światła do klastrów i wysyła listy na GPU.
+     *
+     * @param view Macierz widoku kamery.
+     * @param projection Macierz projekcji perspektywicznej kamery.
+     * @param nearPlane Odległość bliskiej płaszczyzny projekcji.
+     * @param farPlane Odległość dalekiej płaszczyzny projekcji.
+     * @param viewportWidth Szerokość obszaru renderowania w pikselach.
+     * @param viewportHeight Wysokość obszaru renderowania w pikselach.
+     * @param lights Światła sceny w przestrzeni świata.
+     */
+    void update(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane,
+        int viewportWidth, int viewportHeight, const std::vector<PointLight>& lights);
+
+    /**
+     * @brief Rozmiar siatki (x, y, z) i liczba świateł (w) dla bloku FrameData.
+     */
+    glm::uvec4 getGrid() const;
+
+    /**
+     * @brief Rozmiar kafelka w pikselach (x, y) oraz skala i przesunięcie plastra (z, w).
+     *
+     * Plaster fragmentu o głębokości d to floor(log(d) * z - w).
+     */
+    glm::vec4 getParams() const { return params; }
+
+    /**
+     * @brief Łączna liczba przypisań światło-klaster w ostatniej klatce.
+     */
+    size_t getAssignmentCount() const { return lightIndices.size(); }
+
+    /**
+     * @brief Zwalnia bufory SSBO.
+     */
+    ~LightClusters();
+
+private:
+    /**
+     * @struct ClusterRange
+     * @brief Zakres listy świateł klastra w buforze indeksów, układ std430 (uvec2).
+     */
+    struct ClusterRange {
+        uint32_t offset;  /**< Pierwszy indeks listy. */
+        uint32_t count;   /**< Liczba świateł w klastrze. */
+    };
+
+    /**
+     * @brief Wylicza prostopadłościany klastrów w przestrzeni widoku.
+     */
+    void buildClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane);
+
+    /**
+     * @brief Wyznacza plaster zawierający głębokość (odległość wzdłuż osi widzenia).
+     */
+    int sliceFor(float depth) const;
+
+    /**
+     * @brief Wysyła dane do bufora SSBO, powiększając go w razie potrzeby.
+     */
+    static void uploadBuffer(GLuint& buffer, GLsizeiptr& capacity, GLuint binding, const void* data, GLsizeiptr size);
+
+    std::vector<float> minX, minY, minZ;  /**< Minimalne narożniki klastrów (SoA). */
+    std::vector<float> maxX, maxY, maxZ;  /**< Maksymalne narożniki klastrów (SoA). */
+    glm::mat4 boundsProjection{ 0.0f };   /**< Projekcja, dla której policzono prostopadłościany. */
+    float nearPlane = 0.0f;               /**< Bliska płaszczyzna siatki. */
+    float farPlane = 0.0f;                /**< Daleka płaszczyzna siatki. */
+    glm::vec4 params{ 0.0f };             /**< Parametry wyszukiwania klastra w shaderze. */
+    uint32_t lightCount = 0;              /**< Liczba świateł w ostatniej klatce. */
+
+    std::vector<ClusterRange> ranges;     /**< Zakresy list wszystkich klastrów. */
+    std::vector<uint32_t> lightIndices;   /**< Listy świateł klastrów, jedna za drugą. */
+    std::vector<uint32_t> hits;           /**< Pary (klaster, światło) przed sortowaniem. */
+
+    GLuint lightBuffer = 0;               /**< SSBO ze światłami. */
+    GLuint rangeBuffer = 0;               /**< SSBO z zakresami klastrów. */
+    GLuint indexBuffer = 0;               /**< SSBO z indeksami świateł. */
+    GLsizeiptr lightCapacity = 0;         /**< Pojemność bufora świateł w bajtach. */
+    GLsizeiptr rangeCapacity = 0;         /**< Pojemność bufora zakresów w bajtach. */
+    GLsizeiptr indexCapacity = 0;         /**< Pojemność bufora indeksów w bajtach. */
+};
+
+#endif // LIGHTCLUSTERS_H
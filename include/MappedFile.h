@@ -0,0 +1,58 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Plik zmapowany do pamięci tylko do odczytu (mmap / MapViewOfFile).
+ *
+ * Strony pliku wczytuje system przy pierwszym dostępie, więc dane mogą trafić do
+ * glBufferData bezpośrednio z mapowania, bez kopii w buforze aplikacji.
+ * Mapowanie zwalniane jest w destruktorze.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Zwalnia mapowanie.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Mapuje plik do pamięci.
+     *
+     * @param path Ścieżka do pliku.
+     * @return true, jeśli plik istnieje, nie jest pusty i udało się go zmapować.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Zwalnia mapowanie (bezpieczne także dla niezmapowanego pliku).
+     */
+    void close();
+
+    /**
+     * @brief Zwraca początek zmapowanych danych (nullptr, jeśli plik nie jest otwarty).
+     */
+    const unsigned char* data() const { return bytes; }
+
+    /**
+     * @brief Zwraca rozmiar pliku w bajtach.
+     */
+    size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;  /**< Początek mapowania. */
+    size_t length = 0;                     /**< Rozmiar mapowania. */
+#ifdef _WIN32
+    void* fileHandle = nullptr;            /**< Uchwyt pliku (HANDLE). */
+    void* mappingHandle = nullptr;         /**< Uchwyt obiektu mapowania (HANDLE). */
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,286 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <assimp/postprocess.h>
+#include "PackedVertex.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AssetLoader;
+
+/**
+ * @struct MeshVertex
+ * @brief Wierzchołek siatki modelu w układzie bufora VBO.
+ */
+struct MeshVertex {
+    glm::vec3 position;  /**< Pozycja w przestrzeni lokalnej. */
+    glm::vec3 normal;    /**< Wektor normalny. */
+    glm::vec2 texCoord;  /**< Współrzędne tekstury. */
+};
+
+/**
+ * @struct CpuLod
+ * @brief Uproszczona wersja siatki korzystająca z jej bufora wierzchołków.
+ */
+struct CpuLod {
+    std::vector<unsigned int> indices; /**< Indeksy trójkątów poziomu. */
+    float error = 0.0f;                /**< Błąd względem pełnej siatki (w przestrzeni lokalnej). */
+};
+
+/**
+ * @struct CpuMesh
+ * @brief Siatka zaimportowana z pliku, jeszcze nieprzesłana na GPU.
+ */
+struct CpuMesh {
+    std::vector<MeshVertex> vertices;  /**< Wierzchołki siatki. */
+    std::vector<unsigned int> indices; /**< Indeksy trójkątów. */
+    std::vector<CpuLod> lods;          /**< Kolejne, coraz prostsze poziomy szczegółowości. */
+    std::string texturePath;           /**< Ścieżka tekstury diffuse (pusta, jeśli brak). */
+};
+
+/**
+ * @struct CpuModel
+ * @brief Wynik importu modelu: wszystkie siatki wraz z prostopadłościanem otaczającym.
+ */
+struct CpuModel {
+    std::vector<CpuMesh> meshes;           /**< Siatki modelu. */
+    glm::vec3 boundsMin{ 0.0f };           /**< Minimalny narożnik AABB w przestrzeni lokalnej. */
+    glm::vec3 boundsMax{ 0.0f };           /**< Maksymalny narożnik AABB w przestrzeni lokalnej. */
+};
+
+/**
+ * @struct MeshLod
+ * @brief Poziom szczegółowości siatki - zakres wspólnego bufora indeksów.
+ */
+struct MeshLod {
+    GLsizei indexCount = 0;   /**< Liczba indeksów poziomu. */
+    uintptr_t indexOffset = 0; /**< Przesunięcie pierwszego indeksu w EBO (w bajtach). */
+    float error = 0.0f;       /**< Błąd uproszczenia w przestrzeni lokalnej. */
+};
+
+/**
+ * @struct MeshBlob
+ * @brief Siatka w postaci gotowej do przesłania na GPU.
+ *
+ * Wskaźniki danych nie są właścicielami pamięci - wskazują na BakedMesh albo
+ * bezpośrednio na zmapowany plik CookedMesh.
+ */
+struct MeshBlob {
+    const void* vertexData = nullptr;   /**< Zawartość VBO. */
+    size_t vertexBytes = 0;             /**< Rozmiar VBO w bajtach. */
+    const void* indexData = nullptr;    /**< Zawartość EBO (pełna siatka, potem poziomy szczegółowości). */
+    size_t indexBytes = 0;              /**< Rozmiar EBO w bajtach. */
+    GLsizei vertexCount = 0;            /**< Liczba wierzchołków. */
+    GLenum indexType = GL_UNSIGNED_INT; /**< Typ indeksów. */
+    VertexQuantization quantization;    /**< Kwantyzacja pozycji. */
+    std::vector<MeshLod> lods;          /**< Poziomy szczegółowości; lods[0] to pełna siatka. */
+    std::string texturePath;            /**< Ścieżka tekstury diffuse (pusta, jeśli brak). */
+};
+
+/**
+ * @struct BakedMesh
+ * @brief Siatka przekształcona do układu buforów GPU, właściciel danych MeshBlob.
+ */
+struct BakedMesh {
+    std::vector<unsigned char> vertexData; /**< Zawartość VBO. */
+    std::vector<unsigned char> indexData;  /**< Zawartość EBO. */
+    MeshBlob info;                         /**< Opis siatki (bez wskaźników danych). */
+
+    /**
+     * @brief Zwraca opis siatki wskazujący na dane tego obiektu.
+     */
+    MeshBlob view() const;
+};
+
+/**
+ * @struct ModelBlob
+ * @brief Model gotowy do przesłania na GPU.
+ */
+struct ModelBlob {
+    std::vector<MeshBlob> meshes;  /**< Siatki modelu. */
+    glm::vec3 boundsMin{ 0.0f };   /**< Minimalny narożnik AABB w przestrzeni lokalnej. */
+    glm::vec3 boundsMax{ 0.0f };   /**< Maksymalny narożnik AABB w przestrzeni lokalnej. */
+};
+
+/**
+ * @struct GpuMesh
+ * @brief Siatka przesłana na GPU, gotowa do narysowania.
+ */
+struct GpuMesh {
+    GLuint VAO = 0;          /**< Obiekt tablicy wierzchołków. */
+    GLuint VBO = 0;          /**< Bufor wierzchołków. */
+    GLuint EBO = 0;          /**< Bufor indeksów. */
+    GLuint textureID = 0;    /**< Tekstura diffuse (0, jeśli brak). */
+    GLsizei indexCount = 0;  /**< Liczba indeksów pełnej siatki (początek EBO). */
+    GLsizei vertexCount = 0; /**< Liczba wierzchołków w VBO. */
+    GLenum indexType = GL_UNSIGNED_INT; /**< Typ indeksów w EBO (16 bitów dla siatek do 65536 wierzchołków). */
+    VertexQuantization quantization;    /**< Kwantyzacja pozycji (gdy VBO zawiera PackedVertex). */
+    std::vector<MeshLod> lods;          /**< Poziomy szczegółowości; lods[0] to pełna siatka. */
+};
+
+/**
+ * @struct MeshAsset
+ * @brief Niezmienny zasób modelu współdzielony przez wszystkie obiekty, które go używają.
+ *
+ * Destruktor zwalnia bufory i tekstury, więc zasób znika z pamięci GPU razem
+ * z ostatnim uchwytem.
+ */
+struct MeshAsset {
+    std::vector<GpuMesh> meshes;   /**< Siatki modelu. */
+    glm::vec3 boundsMin{ 0.0f };   /**< Minimalny narożnik AABB w przestrzeni lokalnej. */
+    glm::vec3 boundsMax{ 0.0f };   /**< Maksymalny narożnik AABB w przestrzeni lokalnej. */
+    std::vector<float> lodErrors;  /**< Największy błąd siatek modelu na każdym poziomie szczegółowości. */
+    bool ready = false;            /**< Czy siatki są już na GPU (zasób wczytywany w tle jest do tego czasu pusty). */
+
+    MeshAsset() = default;
+    MeshAsset(const MeshAsset&) = delete;
+    MeshAsset& operator=(const MeshAsset&) = delete;
+    ~MeshAsset();
+};
+
+/**
+ * @brief Współdzielony uchwyt do zasobu modelu.
+ */
+using MeshHandle = std::shared_ptr<const MeshAsset>;
+
+/**
+ * @class MeshCache
+ * @brief Pamięć podręczna modeli, indeksowana kanoniczną ścieżką i flagami importu.
+ *
+ * Każdy plik jest importowany i przesyłany na GPU tylko raz, niezależnie od liczby
+ * obiektów, które go używają. Cache przechowuje słabe referencje, więc nie przedłuża
+ * życia zasobów - model jest zwalniany, gdy zniknie ostatni korzystający z niego obiekt.
+ *
+ * Jeśli obok pliku modelu leży nowszy plik przetworzony (CookedMesh, tworzony narzędziem
+ * MeshCooker), model wczytywany jest z niego przez mapowanie pamięci, z pominięciem
+ * Assimp, optymalizacji i generowania poziomów szczegółowości.
+ *
+ * Po ustawieniu programu ładującego (setLoader) acquire() nie blokuje: zwraca pusty
+ * zasób, a odczyt, import i przygotowanie buforów wykonuje wątek roboczy. Siatki
+ * przesyłane są na GPU w AssetLoader::pump() i od tej chwili obiekty je rysują.
+ */
+class MeshCache {
+public:
+    /**
+     * @brief Domyślne flagi importu Assimp używane przez ModelObject.
+     */
+    static constexpr unsigned int DEFAULT_IMPORT_FLAGS =
+        aiProcess_Triangulate |
+        aiProcess_GenSmoothNormals |
+        aiProcess_FlipUVs |
+        aiProcess_CalcTangentSpace;
+
+    /**
+     * @brief Największa liczba poziomów szczegółowości (wraz z pełną siatką).
+     */
+    static constexpr size_t MAX_LOD_LEVELS = 4;
+
+    /**
+     * @brief Docelowa liczba trójkątów kolejnego poziomu względem poprzedniego.
+     */
+    static constexpr float LOD_REDUCTION = 0.5f;
+
+    /**
+     * @brief Największy błąd uproszczenia jako ułamek promienia modelu.
+     */
+    static constexpr float LOD_MAX_RELATIVE_ERROR = 0.05f;
+
+    /**
+     * @brief Zwraca zasób modelu, importując go tylko wtedy, gdy nie ma go w pamięci.
+     *
+     * @param path Ścieżka do pliku modelu.
+     * @param importFlags Flagi przetwarzania Assimp.
+     * @return Uchwyt do zasobu lub nullptr w przypadku błędu importu. Przy wczytywaniu
+     *         w tle zasób jest gotowy dopiero, gdy MeshAsset::ready == true.
+     */
+    static MeshHandle acquire(const std::string& path, unsigned int importFlags = DEFAULT_IMPORT_FLAGS);
+
+    /**
+     * @brief Ustawia program ładujący dla kolejnych wywołań acquire() (nullptr - wczytywanie blokujące).
+     */
+    static void setLoader(AssetLoader* assetLoader);
+
+    /**
+     * @brief Importuje model z pliku do pamięci CPU (bez wywołań OpenGL).
+     *
+     * @param path Ścieżka do pliku modelu.
+     * @param importFlags Flagi przetwarzania Assimp.
+     * @param out Struktura wypełniana zaimportowanymi siatkami.
+     * @param threadCount Liczba wątków parsera OBJ (0 - wszystkie rdzenie).
+     * @return true, jeśli import się powiódł.
+     */
+    static bool importModel(const std::string& path, unsigned int importFlags, CpuModel& out, unsigned int threadCount = 0);
+
+    /**
+     * @brief Przesyła zaimportowany model na GPU. Wymaga aktywnego kontekstu OpenGL.
+     *
+     * @param model Zaimportowany model.
+     * @return Uchwyt do nowego zasobu.
+     */
+    static MeshHandle upload(const CpuModel& model);
+
+    /**
+     * @brief Przesyła na GPU model w postaci gotowych buforów. Wymaga aktywnego kontekstu OpenGL.
+     *
+     * @param model Bufory siatek (np. wskazujące na zmapowany plik).
+     * @return Uchwyt do nowego zasobu.
+     */
+    static MeshHandle upload(const ModelBlob& model);
+
+    /**
+     * @brief Konfiguruje atrybuty 0-2 aktualnie związanego VAO dla bufora PackedVertex.
+     */
+    static void setupPackedVertexAttributes();
+
+    /**
+     * @brief Przekształca siatkę do układu buforów GPU (bez wywołań OpenGL).
+     *
+     * Wierzchołki są pakowane (PACK_MESH_VERTICES), indeksy pełnej siatki i poziomów
+     * szczegółowości łączone w jeden bufor 16- lub 32-bitowy.
+     *
+     * @param mesh Zaimportowana siatka.
+     * @param out Wynik.
+     */
+    static void bake(const CpuMesh& mesh, BakedMesh& out);
+
+    /**
+     * @brief Tworzy klucz cache na podstawie kanonicznej ścieżki i flag importu.
+     */
+    static std::string makeKey(const std::string& path, unsigned int importFlags);
+
+    /**
+     * @brief Zwraca liczbę modeli aktualnie obecnych w pamięci.
+     */
+    static size_t residentCount();
+
+    /**
+     * @brief Wyznacza kwantyzację pozycji z prostopadłościanu otaczającego wierzchołki.
+     */
+    static VertexQuantization quantizationFor(const std::vector<MeshVertex>& vertices);
+
+    /**
+     * @brief Tworzy łańcuch poziomów szczegółowości siatki.
+     *
+     * Każdy poziom upraszcza poprzedni do LOD_REDUCTION trójkątów; generowanie kończy się,
+     * gdy uproszczenie przekroczyłoby granicę błędu lub nie zmniejszyło wyraźnie siatki.
+     *
+     * @param mesh Siatka (po optymalizacji), do której dopisywane są poziomy.
+     * @param maxError Największy dopuszczalny błąd w przestrzeni lokalnej.
+     */
+    static void generateLods(CpuMesh& mesh, float maxError);
+
+private:
+    /**
+     * @brief Tworzy bufory siatek w istniejącym zasobie i oznacza go jako gotowy.
+     */
+    static void uploadInto(MeshAsset& asset, const ModelBlob& model);
+
+    static std::unordered_map<std::string, std::weak_ptr<const MeshAsset>> entries;
+    static AssetLoader* loader;
+};
+
+#endif // MESHCACHE_H
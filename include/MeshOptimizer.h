@@ -0,0 +1,99 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include "MeshCache.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct MeshOptimizationStats
+ * @brief Wyniki optymalizacji siatki (ACMR = średnia liczba chybień pamięci wierzchołków na trójkąt).
+ */
+struct MeshOptimizationStats {
+    size_t verticesBefore = 0;   /**< Wierzchołki przed spawaniem. */
+    size_t verticesAfter = 0;    /**< Wierzchołki po spawaniu. */
+    size_t triangles = 0;        /**< Liczba trójkątów. */
+    float acmrBefore = 0.0f;     /**< ACMR kolejności z pliku. */
+    float acmrAfter = 0.0f;      /**< ACMR po optymalizacji. */
+};
+
+/**
+ * @class MeshOptimizer
+ * @brief Optymalizacja siatek przy imporcie pod kątem przepustowości wierzchołków GPU.
+ *
+ * Etapy (w kolejności wykonywania w optimize()):
+ * 1. spawanie identycznych wierzchołków (dokładne porównanie pozycji, normalnej i UV),
+ * 2. kolejność trójkątów pod pamięć podręczną wierzchołków po transformacji (algorytm
+ *    Forsytha z symulowaną pamięcią LRU),
+ * 3. kolejność klastrów trójkątów ograniczająca overdraw: sekwencja z etapu 2 dzielona
+ *    jest na klastry tam, gdzie ACMR lokalnie spada poniżej progu, a klastry sortowane
+ *    od zwróconych na zewnątrz siatki (zasłaniających) do zwróconych do środka,
+ * 4. kolejność wierzchołków według pierwszego użycia (lokalność pobierania z VBO).
+ *
+ * ACMR mierzony jest symulacją pamięci FIFO o rozmiarze typowym dla GPU.
+ */
+class MeshOptimizer {
+public:
+    /**
+     * @brief Rozmiar symulowanej pamięci FIFO używanej do pomiaru ACMR.
+     */
+    static constexpr size_t FIFO_CACHE_SIZE = 16;
+
+    /**
+     * @brief Próg ACMR dla klastrów overdraw (1.05 = dopuszczalne 5% pogorszenia).
+     */
+    static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+    /**
+     * @brief Wykonuje wszystkie etapy optymalizacji siatki.
+     *
+     * @param mesh Siatka modyfikowana w miejscu.
+     * @return Statystyki przed i po optymalizacji.
+     */
+    static MeshOptimizationStats optimize(CpuMesh& mesh);
+
+    /**
+     * @brief Łączy identyczne wierzchołki i przenumerowuje indeksy.
+     */
+    static void weldVertices(CpuMesh& mesh);
+
+    /**
+     * @brief Porządkuje trójkąty pod pamięć wierzchołków po transformacji (algorytm Forsytha).
+     *
+     * @param indices Indeksy trójkątów, modyfikowane w miejscu.
+     * @param vertexCount Liczba wierzchołków siatki.
+     */
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    /**
+     * @brief Porządkuje klastry trójkątów tak, by ograniczyć overdraw.
+     *
+     * Oczekuje indeksów już uporządkowanych przez optimizeVertexCache().
+     *
+     * @param indices Indeksy trójkątów, modyfikowane w miejscu.
+     * @param vertices Wierzchołki siatki.
+     * @param threshold Dopuszczalny stosunek ACMR klastra do ACMR całości.
+     */
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<MeshVertex>& vertices,
+        float threshold = OVERDRAW_THRESHOLD);
+
+    /**
+     * @brief Ustawia wierzchołki w kolejności pierwszego użycia przez indeksy.
+     *
+     * Wierzchołki nieużywane przez żaden trójkąt są usuwane.
+     */
+    static void optimizeVertexFetch(CpuMesh& mesh);
+
+    /**
+     * @brief Liczy ACMR dla symulowanej pamięci FIFO.
+     *
+     * @param indices Indeksy trójkątów.
+     * @param vertexCount Liczba wierzchołków siatki.
+     * @param cacheSize Rozmiar pamięci FIFO.
+     * @return Średnia liczba chybień na trójkąt (0 dla pustej siatki).
+     */
+    static float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount,
+        size_t cacheSize = FIFO_CACHE_SIZE);
+};
+
+#endif // MESHOPTIMIZER_H
@@ -0,0 +1,36 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "MeshCache.h"
+#include <vector>
+
+/**
+ * @class MeshSimplifier
+ * @brief Upraszczanie siatek przez zwijanie krawędzi z metryką błędu kwadryk.
+ *
+ * Każdy wierzchołek dostaje kwadrykę - sumę kwadratów odległości od płaszczyzn jego
+ * trójkątów. Zwinięcie krawędzi przenosi wierzchołek na jednego z sąsiadów (bez
+ * tworzenia nowych wierzchołków), więc uproszczone listy indeksów korzystają z tego
+ * samego bufora wierzchołków co pełna siatka.
+ *
+ * Wierzchołki na brzegach siatki i na szwach atrybutów (ta sama pozycja, różna normalna
+ * lub UV) nie są przesuwane, dzięki czemu w siatce nie powstają szczeliny. Zwinięcia
+ * odwracające trójkąty są odrzucane.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief Upraszcza siatkę do docelowej liczby indeksów lub do granicy błędu.
+     *
+     * @param vertices Wierzchołki siatki.
+     * @param indices Indeksy trójkątów upraszczanej siatki.
+     * @param targetIndexCount Docelowa liczba indeksów.
+     * @param maxError Największy dopuszczalny błąd (odległość w przestrzeni lokalnej).
+     * @param resultError Zwraca błąd osiągniętego uproszczenia (może być nullptr).
+     * @return Indeksy uproszczonej siatki.
+     */
+    static std::vector<unsigned int> simplify(const std::vector<MeshVertex>& vertices,
+        const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, float* resultError = nullptr);
+};
+
+#endif // MESHSIMPLIFIER_H
@@ -0,0 +1,52 @@
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct MipLevel
+ * @brief Poziom łańcucha mipmap w buforze MipChain.
+ */
+struct MipLevel {
+    int width = 0;      /**< Szerokość poziomu w pikselach. */
+    int height = 0;     /**< Wysokość poziomu w pikselach. */
+    size_t offset = 0;  /**< Przesunięcie danych poziomu w buforze (w bajtach). */
+    size_t size = 0;    /**< Rozmiar danych poziomu w bajtach (wiersze bez wyrównania). */
+};
+
+/**
+ * @struct MipChain
+ * @brief Pełny łańcuch mipmap obrazu 8-bitowego, budowany na CPU.
+ *
+ * Każdy poziom powstaje z poprzedniego filtrem pudełkowym 2x2 - tym samym, którego
+ * zwykle używa glGenerateMipmap - więc wynik nie zmienia wyglądu tekstur, a cały
+ * łańcuch można przesłać na GPU bez czekania na sterownik. Sumowanie wierszy i (dla
+ * obrazów RGBA) uśrednianie pikseli wykonywane jest instrukcjami SSE2, gdy są dostępne.
+ * Przy nieparzystym wymiarze ostatnia kolumna lub wiersz poziomu jest pomijana.
+ *
+ * Budowanie nie wywołuje OpenGL, więc może działać w wątku roboczym.
+ */
+struct MipChain {
+    int channels = 0;                /**< Liczba kanałów na piksel (1-4). */
+    std::vector<unsigned char> data; /**< Wszystkie poziomy, jeden po drugim. */
+    std::vector<MipLevel> levels;    /**< Opis poziomów; levels[0] to obraz źródłowy. */
+
+    /**
+     * @brief Buduje łańcuch mipmap aż do poziomu 1x1.
+     *
+     * @param pixels Piksele obrazu, wiersz po wierszu, bez wyrównania wierszy.
+     * @param width Szerokość obrazu.
+     * @param height Wysokość obrazu.
+     * @param channels Liczba kanałów na piksel.
+     * @param out Wynik.
+     */
+    static void build(const unsigned char* pixels, int width, int height, int channels, MipChain& out);
+
+    /**
+     * @brief Zwraca dane poziomu.
+     */
+    const unsigned char* levelData(size_t level) const { return data.data() + levels[level].offset; }
+};
+
+#endif // MIPCHAIN_H
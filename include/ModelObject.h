@@ -3,22 +3,16 @@
 
 #include "DrawableObject.h"
 #include "TransformableObject.h"
-#include "BitMapHandler.h"
+#include "MeshCache.h"
 #include <string>
-#include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
 
 class ModelObject : public DrawableObject, public TransformableObject {
 public:
     ModelObject(const std::string& path);
-    void draw(GLuint shaderProgram,
-        const glm::mat4& model,
-        const glm::mat4& view,
-        const glm::mat4& projection) override;
+    void submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const override;
+    BoundingSphere getBoundingSphere() const override;
     void setPosition(const glm::vec3& pos);
     void setScale(const glm::vec3& scale);
     void translate(const glm::vec3& direction) override;
@@ -26,31 +20,66 @@ public:
     void rotatePoint(float angle, const glm::vec3& axis, const glm::vec3& point) override;
     void scale(float sx, float sy) override;
     glm::mat4 getModelMatrix() const;
+    const MeshHandle& getAsset() const { return asset; }
 
-protected:
-    struct Vertex {
-        glm::vec3 position;
-        glm::vec3 normal;
-        glm::vec2 texCoord;
-    };
+    /**
+     * @brief Czy siatki modelu są już na GPU (przy wczytywaniu w tle obiekt do tego czasu nic nie rysuje).
+     */
+    bool isLoaded() const { return asset && asset->ready; }
+
+    /**
+     * @brief Dopuszczalny błąd poziomu szczegółowości w pikselach (przebieg główny).
+     */
+    static constexpr float LOD_PIXEL_ERROR = 1.0f;
+
+    /**
+     * @brief Dopuszczalny błąd poziomu szczegółowości w pikselach (mapy cieni).
+     */
+    static constexpr float SHADOW_LOD_PIXEL_ERROR = 4.0f;
 
+    /**
+     * @brief Względny margines progu przy zmianie poziomu, zapobiegający miganiu.
+     */
+    static constexpr float LOD_HYSTERESIS = 0.25f;
+
+    /**
+     * @brief Wybiera poziom szczegółowości z rzutowanego na ekran błędu uproszczenia.
+     *
+     * Wybierany jest najprostszy poziom, którego błąd po rzutowaniu nie przekracza progu
+     * przebiegu. Przejście na prostszy poziom wymaga zapasu LOD_HYSTERESIS poniżej progu,
+     * powrót na dokładniejszy - przekroczenia progu o LOD_HYSTERESIS. Przebieg główny
+     * i mapy cieni pamiętają swój poziom osobno; broń (Overlay) zawsze używa pełnej siatki.
+     *
+     * @param queue Kolejka z pozycją kamery i skalą projekcji.
+     * @param pass Przebieg, dla którego wybierany jest poziom.
+     * @param model Macierz modelu.
+     * @return Indeks poziomu (0 = pełna siatka).
+     */
+    size_t selectLod(const RenderQueue& queue, RenderPass pass, const glm::mat4& model) const;
+
+protected:
     glm::vec3 position{ 0.0f };
     glm::vec3 scaleVec{ 1.0f };
     glm::vec3 rotationAxis{ 0.0f, 1.0f, 0.0f };
     float rotationAngle{ 0.0f };
 
-    struct Mesh {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-        GLuint VAO=0, VBO=0, EBO=0;
-        GLuint textureID = 0;
-    };
+    /**
+     * Współdzielony zasób modelu z MeshCache. Wszystkie obiekty tego samego pliku
+     * korzystają z jednego zestawu VAO/VBO/EBO, dzięki czemu kolejka renderowania
+     * może narysować je jednym wywołaniem instancjonowanym.
+     */
+    MeshHandle asset;
 
-    std::vector<Mesh> meshes;
+    /**
+     * Sfera otaczająca w przestrzeni lokalnej, wyznaczana raz z AABB zasobu,
+     * gdy ten zostanie wczytany.
+     */
+    mutable BoundingSphere localBounds;
 
-    void loadModel(const std::string& path);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    void setupMesh(Mesh& mesh);
+    /**
+     * Ostatnio wybrane poziomy szczegółowości: przebieg główny i mapy cieni.
+     */
+    mutable size_t lodLevel[2] = { 0, 0 };
 };
 
 #endif //MODELOBJECT_H
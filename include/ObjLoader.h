@@ -0,0 +1,42 @@
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+#include "MeshCache.h"
+#include <string>
+
+/**
+ * @class ObjLoader
+ * @brief Wielowątkowy czytnik plików OBJ/MTL, zastępujący Assimp dla modeli .obj.
+ *
+ * Plik jest mapowany do pamięci i dzielony na fragmenty zakończone pełnymi liniami,
+ * parsowane równolegle (std::from_chars). Indeksy ujemne rozwiązywane są po scaleniu,
+ * gdy znane są liczności elementów z wcześniejszych fragmentów. Trójki indeksów
+ * pozycja/uv/normalna łączone są w wierzchołki MeshVertex równolegle: każdy wątek
+ * obsługuje własną część przestrzeni skrótów.
+ *
+ * Ściany dzielone są na siatki według materiału (usemtl), wielokąty triangulowane
+ * wachlarzem. Flagi importu interpretowane są tak jak w Assimp w zakresie, którego
+ * używa gra: aiProcess_FlipUVs odwraca v, aiProcess_GenSmoothNormals /
+ * aiProcess_GenNormals generują normalne dla ścian bez nich.
+ */
+class ObjLoader {
+public:
+    /**
+     * @brief Sprawdza, czy plik ma rozszerzenie .obj.
+     */
+    static bool canLoad(const std::string& path);
+
+    /**
+     * @brief Wczytuje model OBJ wraz z materiałami z plików mtllib.
+     *
+     * @param path Ścieżka do pliku .obj.
+     * @param importFlags Flagi importu (zgodne z Assimp).
+     * @param out Siatki modelu (bez prostopadłościanu otaczającego).
+     * @param threadCount Liczba wątków parsowania i łączenia wierzchołków (0 - wszystkie rdzenie;
+     *        1 w wątkach AssetLoader, które już wczytują kilka modeli równolegle).
+     * @return false, jeśli pliku nie da się wczytać lub jest niepoprawny.
+     */
+    static bool load(const std::string& path, unsigned int importFlags, CpuModel& out, unsigned int threadCount = 0);
+};
+
+#endif // OBJLOADER_H
@@ -144,8 +144,8 @@ public:
     float speed = 5.0f;
     bool onGround = false;
 
-    void applyMovementInput(const std::set<char>& keys, float deltaTime, const std::vector<Wall*>& world);
-    void updatePhysics(float deltaTime, const std::vector<Wall*>& world);
+    void applyMovementInput(const std::set<char>& keys, float deltaTime, const std::vector<CollisionBox>& world);
+    void updatePhysics(float deltaTime, const std::vector<CollisionBox>& world);
     bool rayIntersectsAABB(const glm::vec3& origin,
         const glm::vec3& dir,
         const glm::vec3& aabbMin,
@@ -0,0 +1,77 @@
+#ifndef PACKEDVERTEX_H
+#define PACKEDVERTEX_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+struct MeshVertex;
+
+/**
+ * @brief Włącza skompresowany układ wierzchołków dla siatek modeli i areny statycznej.
+ *
+ * Przy wartości false siatki trafiają na GPU jako MeshVertex (32 bajty na wierzchołek).
+ */
+constexpr bool PACK_MESH_VERTICES = true;
+
+/**
+ * @struct PackedVertex
+ * @brief Skompresowany wierzchołek siatki (16 bajtów zamiast 32).
+ *
+ * - pozycja: 3 x 16 bitów znormalizowane względem AABB siatki, czwarta składowa równa 0
+ *   (znacznik dla vertex shadera, że normalna jest zakodowana oktaedrycznie),
+ * - normalna: 2 x 16 bitów ze znakiem, kodowanie oktaedryczne,
+ * - współrzędne tekstury: 2 x half float.
+ *
+ * Pozycja dekodowana jest przez macierz modelu instancji (patrz VertexQuantization),
+ * normalna - w vertex shaderze.
+ */
+struct PackedVertex {
+    uint16_t position[4];  /**< Pozycja w zakresie AABB siatki (x, y, z, 0). */
+    int16_t normal[2];     /**< Normalna zakodowana oktaedrycznie. */
+    uint16_t texCoord[2];  /**< Współrzędne tekstury (half float). */
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be tightly packed");
+
+/**
+ * @struct VertexQuantization
+ * @brief Odwzorowanie pozycji skwantowanej (0..1 po normalizacji) na przestrzeń lokalną siatki.
+ *
+ * Pozycja lokalna = offset + pozycja * scale. Dla wierzchołków niespakowanych jest to
+ * odwzorowanie tożsamościowe.
+ */
+struct VertexQuantization {
+    glm::vec3 offset{ 0.0f };  /**< Minimalny narożnik AABB siatki. */
+    glm::vec3 scale{ 1.0f };   /**< Rozmiar AABB siatki. */
+
+    /**
+     * @brief Wyznacza kwantyzację dla prostopadłościanu otaczającego.
+     */
+    static VertexQuantization fromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+    /**
+     * @brief Dokłada odwzorowanie do macierzy modelu (model * translate(offset) * scale(scale)).
+     */
+    glm::mat4 apply(const glm::mat4& model) const;
+};
+
+/**
+ * @brief Kompresuje wierzchołek siatki.
+ *
+ * @param vertex Wierzchołek w pełnej precyzji.
+ * @param quantization Kwantyzacja pozycji siatki.
+ * @return Spakowany wierzchołek.
+ */
+PackedVertex packVertex(const MeshVertex& vertex, const VertexQuantization& quantization);
+
+/**
+ * @brief Koduje wektor jednostkowy na ośmiościanie (wynik w zakresie -1..1).
+ */
+glm::vec2 encodeOctahedral(const glm::vec3& normal);
+
+/**
+ * @brief Konwertuje liczbę zmiennoprzecinkową na half float (IEEE 754 binary16).
+ */
+uint16_t floatToHalf(float value);
+
+#endif // PACKEDVERTEX_H
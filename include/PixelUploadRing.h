@@ -0,0 +1,86 @@
+#ifndef PIXELUPLOADRING_H
+#define PIXELUPLOADRING_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <deque>
+
+/**
+ * @class PixelUploadRing
+ * @brief Pierścieniowy bufor GL_PIXEL_UNPACK_BUFFER do asynchronicznego przesyłania tekstur.
+ *
+ * Dane tekseli kopiowane są do zmapowanej pamięci bufora, a glTexSubImage2D czyta je
+ * z bufora zamiast z pamięci klienta - wywołanie nie czeka, aż sterownik skopiuje dane.
+ * Gdy dostępne jest GL_ARB_buffer_storage, bufor mapowany jest raz, trwale
+ * (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT); w przeciwnym razie każdy zapis mapuje
+ * swój zakres bez synchronizacji.
+ *
+ * Zakresy zapisane od ostatniego fence() zamykane są wspólnym obiektem synchronizacji;
+ * reclaim() zwalnia zakresy, których polecenia GPU już wykonało. Dopóki tak się nie
+ * stanie, pamięć nie jest nadpisywana - write() zwraca wtedy false.
+ */
+class PixelUploadRing {
+public:
+    /**
+     * @brief Tworzy bufor o podanej pojemności.
+     */
+    explicit PixelUploadRing(size_t capacity);
+
+    /**
+     * @brief Czeka na zakończenie przesyłania i zwalnia bufor.
+     */
+    ~PixelUploadRing();
+
+    PixelUploadRing(const PixelUploadRing&) = delete;
+    PixelUploadRing& operator=(const PixelUploadRing&) = delete;
+
+    /**
+     * @brief Kopiuje dane do wolnego zakresu pierścienia.
+     *
+     * @param data Dane do skopiowania.
+     * @param size Rozmiar danych w bajtach.
+     * @param offset Zwraca przesunięcie danych w buforze (argument "pixels" wywołań glTex*Image).
+     * @return false, jeśli w pierścieniu nie ma teraz miejsca (lub dane są większe niż pojemność).
+     */
+    bool write(const void* data, size_t size, size_t& offset);
+
+    /**
+     * @brief Przypina bufor do GL_PIXEL_UNPACK_BUFFER.
+     */
+    void bind() const { glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer); }
+
+    /**
+     * @brief Zamyka zakresy zapisane od ostatniego wywołania; wołać po poleceniach, które z nich czytają.
+     */
+    void fence();
+
+    /**
+     * @brief Zwalnia zakresy, których przesyłanie zakończyło się na GPU (bez czekania).
+     */
+    void reclaim();
+
+    /**
+     * @brief Pojemność pierścienia w bajtach.
+     */
+    size_t getCapacity() const { return capacity; }
+
+private:
+    /**
+     * @struct Region
+     * @brief Zakres zamknięty obiektem synchronizacji.
+     */
+    struct Region {
+        size_t bytes;  /**< Rozmiar zakresu (wraz z pominiętym końcem bufora przy zawinięciu). */
+        GLsync sync;   /**< Sygnalizowany, gdy GPU przeczyta zakres. */
+    };
+
+    GLuint buffer = 0;                 /**< Bufor OpenGL. */
+    unsigned char* mapped = nullptr;   /**< Trwałe mapowanie (nullptr bez GL_ARB_buffer_storage). */
+    size_t capacity;                   /**< Pojemność w bajtach. */
+    size_t tail = 0;                   /**< Początek najstarszego zajętego zakresu. */
+    size_t used = 0;                   /**< Zajęte bajty od tail. */
+    size_t unfenced = 0;               /**< Bajty zapisane od ostatniego fence(). */
+    std::deque<Region> regions;        /**< Zakresy w toku, od najstarszego. */
+};
+
+#endif // PIXELUPLOADRING_H
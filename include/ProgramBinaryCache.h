@@ -0,0 +1,62 @@
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class ProgramBinaryCache
+ * @brief Dyskowa pamięć podręczna zlinkowanych programów (glGetProgramBinary / glProgramBinary).
+ *
+ * Klucz to 64-bitowy skrót FNV-1a z kodu źródłowego wszystkich etapów (już po wstawieniu
+ * definicji permutacji) oraz napisów GL_VENDOR, GL_RENDERER i GL_VERSION, więc zmiana
+ * shadera, wariantu albo sterownika daje nowy klucz. Każdy program to jeden plik
+ * w katalogu shader_cache/. Plik nieczytelny, uszkodzony lub odrzucony przez sterownik
+ * jest ignorowany - program kompilowany jest wtedy ze źródeł i zapisywany ponownie.
+ */
+class ProgramBinaryCache {
+public:
+    /**
+     * @brief Wylicza klucz programu z kodu źródłowego jego etapów i wersji sterownika.
+     *
+     * @param sources Kod źródłowy etapów w kolejności dołączania.
+     * @return Klucz pamięci podręcznej.
+     */
+    static uint64_t makeKey(const std::vector<std::string>& sources);
+
+    /**
+     * @brief Próbuje wczytać program z pamięci podręcznej.
+     *
+     * @param program Pusty program utworzony przez glCreateProgram.
+     * @param key Klucz z makeKey().
+     * @return true, jeśli sterownik przyjął binarium i program jest zlinkowany.
+     */
+    static bool load(GLuint program, uint64_t key);
+
+    /**
+     * @brief Zapisuje binarium zlinkowanego programu.
+     *
+     * Program musi być linkowany z GL_PROGRAM_BINARY_RETRIEVABLE_HINT. Plik zapisywany jest
+     * pod nazwą tymczasową i dopiero potem podmieniany, więc przerwany zapis nie zostawia
+     * uszkodzonego wpisu.
+     *
+     * @param program Zlinkowany program.
+     * @param key Klucz z makeKey().
+     */
+    static void store(GLuint program, uint64_t key);
+
+    /**
+     * @brief Sprawdza, czy sterownik obsługuje choć jeden format binariów programów.
+     */
+    static bool isSupported();
+
+private:
+    /**
+     * @brief Ścieżka pliku wpisu o podanym kluczu.
+     */
+    static std::string pathFor(uint64_t key);
+};
+
+#endif // PROGRAMBINARYCACHE_H
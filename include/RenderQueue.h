@@ -0,0 +1,255 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Shader.h"
+#include "PackedVertex.h"
+
+/**
+ * @enum RenderPass
+ * @brief Przebiegi renderowania (wartość wyznacza kolejność w posortowanej kolejce).
+ */
+enum class RenderPass : uint8_t {
+    Shadow = 0,       /**< Dynamiczne obiekty w mapach cieni (raz dla każdego światła). */
+    Main = 1,         /**< Główny przebieg sceny. */
+    Overlay = 2,      /**< Elementy rysowane własną kamerą (trzymana broń). */
+    ShadowStatic = 3  /**< Statyczna warstwa map cieni, renderowana tylko po jej unieważnieniu. */
+};
+
+/**
+ * @brief Sprawdza, czy przebieg renderuje mapę cieni.
+ */
+inline bool isShadowPass(RenderPass pass) {
+    return pass == RenderPass::Shadow || pass == RenderPass::ShadowStatic;
+}
+
+/**
+ * @brief Pierwsza lokalizacja atrybutu macierzy instancji (mat4 zajmuje lokalizacje 3-6).
+ */
+constexpr GLuint INSTANCE_ATTRIBUTE_LOCATION = 3;
+
+/**
+ * @brief Pierwsza lokalizacja macierzy normalnych instancji (mat3 zajmuje lokalizacje 7-9).
+ */
+constexpr GLuint INSTANCE_NORMAL_LOCATION = 7;
+
+/**
+ * @struct InstanceData
+ * @brief Dane jednej instancji w buforze instancji (macierz modelu i macierz normalnych).
+ *
+ * Kolumny macierzy normalnych zapisane są jako vec4, więc każda zaczyna się od
+ * wyrównanego adresu; shader czyta z nich tylko xyz.
+ */
+struct InstanceData {
+    glm::mat4 model;             /**< Macierz modelu. */
+    glm::vec4 normalMatrix[3];   /**< Kolumny macierzy normalnych (xyz). */
+};
+
+static_assert(sizeof(InstanceData) == 112, "InstanceData must be tightly packed");
+
+/**
+ * @brief Wylicza dane instancji dla macierzy modelu.
+ *
+ * Macierz normalnych to transpose(inverse(mat3(model))). Gdy kolumny mat3(model) są
+ * wzajemnie prostopadłe i równej długości (obrót z jednolitą skalą), wynik różni się
+ * od mat3(model) tylko skalą, którą i tak usuwa normalizacja w shaderze - odwracanie
+ * macierzy jest wtedy pomijane.
+ *
+ * @param model Macierz modelu.
+ * @return Dane instancji.
+ */
+InstanceData makeInstanceData(const glm::mat4& model);
+
+/**
+ * @brief Wylicza dane instancji dla siatki o skwantowanych pozycjach.
+ *
+ * Odwzorowanie kwantyzacji trafia do macierzy modelu, macierz normalnych liczona jest
+ * z samej macierzy modelu.
+ *
+ * @param model Macierz modelu.
+ * @param quantization Kwantyzacja pozycji siatki.
+ * @return Dane instancji.
+ */
+InstanceData makeInstanceData(const glm::mat4& model, const VertexQuantization& quantization);
+
+/**
+ * @brief Indeks wiązania bufora wierzchołków z danymi instancji.
+ *
+ * Wybrany poza zakresem 0-2, który glVertexAttribPointer zajmuje dla atrybutów siatki.
+ */
+constexpr GLuint INSTANCE_BUFFER_BINDING = 8;
+
+/**
+ * @struct DrawPacket
+ * @brief Pojedyncze wywołanie rysowania zgłoszone przez obiekt sceny.
+ */
+struct DrawPacket {
+    const Shader* shader = nullptr;  /**< Program cieniujący. */
+    GLuint vao = 0;                  /**< VAO z buforami siatki. */
+    GLuint texture = 0;              /**< Tekstura (0 = tekstura domyślna kolejki). */
+    GLsizei indexCount = 0;          /**< Liczba indeksów do narysowania. */
+    GLenum indexType = GL_UNSIGNED_INT; /**< Typ indeksów w EBO. */
+    uintptr_t indexOffset = 0;       /**< Przesunięcie pierwszego indeksu w EBO (w bajtach). */
+    bool doubleSided = false;        /**< Wyłącza odrzucanie ścian (np. ściany pomieszczenia). */
+    glm::mat4 model{ 1.0f };         /**< Macierz modelu. */
+    VertexQuantization quantization; /**< Kwantyzacja pozycji siatki (stała dla VAO). */
+};
+
+/**
+ * @class RenderQueue
+ * @brief Kolejka rysowania sortowana kluczem stanu.
+ *
+ * Obiekty sceny zgłaszają pakiety rysowania zamiast rysować bezpośrednio. Każdy pakiet
+ * dostaje 64-bitowy klucz (przebieg, tryb odrzucania ścian, program, tekstura, VAO,
+ * głębokość od przodu do tyłu), kolejka jest sortowana pozycyjnie (radix sort),
+ * a wykonanie pomija powiązania stanu, które już są aktywne.
+ *
+ * Po sortowaniu sąsiednie pakiety z tym samym stanem i tą samą siatką łączone są
+ * w partie rysowane jednym glDrawElementsInstancedBaseInstance. Macierze modelu
+ * i normalnych wszystkich pakietów trafiają raz na klatkę do bufora instancji, czytanego
+ * przez shadery jako atrybut z dzielnikiem 1, więc N identycznych obiektów kosztuje
+ * jedno wywołanie na przebieg zamiast N.
+ *
+ * Układ klucza (od najstarszego bitu):
+ * - 63..62 przebieg,
+ * - 61..60 tryb odrzucania ścian,
+ * - 59..52 program,
+ * - 51..40 tekstura,
+ * - 39..24 VAO,
+ * - 23..0  głębokość (tylko przebieg główny).
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief Usuwa wszystkie pakiety z poprzedniej klatki.
+     */
+    void clear();
+
+    /**
+     * @brief Ustawia punkt widzenia używany do sortowania od przodu do tyłu.
+     *
+     * @param position Pozycja kamery w przestrzeni świata.
+     * @param farPlane Odległość, do której kwantyzowana jest głębokość.
+     */
+    void setViewPoint(const glm::vec3& position, float farPlane);
+
+    /**
+     * @brief Ustawia skalę projekcji używaną do wyboru poziomów szczegółowości.
+     *
+     * @param pixelsPerUnit Liczba pikseli ekranu, którą zajmuje odcinek długości 1
+     *        w odległości 1 od kamery (wysokość okna / (2 tan(fov / 2))).
+     */
+    void setLodProjection(float pixelsPerUnit);
+
+    /**
+     * @brief Zwraca pozycję kamery ustawioną przez setViewPoint().
+     */
+    const glm::vec3& getViewPosition() const { return viewPosition; }
+
+    /**
+     * @brief Zwraca skalę projekcji ustawioną przez setLodProjection() (0 = nieustawiona).
+     */
+    float getLodProjection() const { return lodProjection; }
+
+    /**
+     * @brief Ustawia teksturę wiązaną dla pakietów bez własnej tekstury.
+     *
+     * @param textureID Identyfikator tekstury OpenGL.
+     */
+    void setDefaultTexture(GLuint textureID);
+
+    /**
+     * @brief Rejestruje wariant programu dla pakietów bez własnej tekstury.
+     *
+     * Pakiety z teksturą 0 zgłoszone z programem shader są rysowane programem untextured
+     * (np. permutacją bez próbkowania tekstury). Rejestracje obowiązują do clear().
+     *
+     * @param shader Program zgłaszany przez obiekty sceny.
+     * @param untextured Program używany zamiast niego dla pakietów bez tekstury.
+     */
+    void setUntexturedVariant(const Shader& shader, const Shader& untextured);
+
+    /**
+     * @brief Dodaje pakiet rysowania do kolejki.
+     *
+     * @param pass Przebieg, w którym pakiet ma zostać narysowany.
+     * @param packet Dane wywołania rysowania.
+     * @param worldCenter Środek obiektu w przestrzeni świata (do sortowania po głębokości).
+     */
+    void submit(RenderPass pass, const DrawPacket& packet, const glm::vec3& worldCenter);
+
+    /**
+     * @brief Sortuje pakiety, łączy je w partie instancji i wysyła macierze modelu.
+     *
+     * Wywoływane raz na klatkę, po zgłoszeniu wszystkich obiektów.
+     */
+    void sort();
+
+    /**
+     * @brief Wykonuje pakiety wskazanego przebiegu.
+     *
+     * Przebieg może być wykonany wielokrotnie (np. raz na każde światło).
+     *
+     * @param pass Przebieg do wykonania.
+     */
+    void execute(RenderPass pass);
+
+    /**
+     * @brief Konfiguruje atrybuty instancji w aktualnie związanym VAO.
+     *
+     * Wywoływane przy tworzeniu każdego VAO rysowanego przez kolejkę; sam bufor
+     * instancji wiązany jest dopiero podczas wykonywania.
+     */
+    static void setupInstanceAttributes();
+
+    /**
+     * @brief Zwalnia bufor instancji.
+     */
+    ~RenderQueue();
+
+private:
+    /**
+     * @struct SortItem
+     * @brief Klucz sortowania wraz z indeksem pakietu.
+     */
+    struct SortItem {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<DrawPacket> packets;      /**< Pakiety w kolejności zgłoszenia. */
+    std::vector<SortItem> items;          /**< Klucze sortowania. */
+    std::vector<SortItem> scratch;        /**< Bufor pomocniczy sortowania pozycyjnego. */
+
+    /**
+     * @struct Batch
+     * @brief Partia pakietów o identycznym stanie i siatce rysowana instancyjnie.
+     */
+    struct Batch {
+        RenderPass pass;        /**< Przebieg partii. */
+        uint32_t cull;          /**< Tryb odrzucania ścian. */
+        uint32_t packetIndex;   /**< Pakiet reprezentujący stan partii. */
+        GLuint baseInstance;    /**< Pierwsza instancja w buforze instancji. */
+        GLsizei instanceCount;  /**< Liczba instancji. */
+    };
+
+    std::vector<Batch> batches;           /**< Partie w kolejności wykonania. */
+    std::vector<InstanceData> instances;  /**< Dane instancji w kolejności partii. */
+    GLuint instanceBuffer = 0;            /**< Bufor instancji. */
+    GLsizeiptr instanceCapacity = 0;      /**< Pojemność bufora instancji w bajtach. */
+    glm::vec3 viewPosition{ 0.0f };       /**< Pozycja kamery. */
+    float depthScale = 1.0f;              /**< Skala kwantyzacji głębokości. */
+    float lodProjection = 0.0f;           /**< Piksele na jednostkę długości w odległości 1. */
+    GLuint defaultTexture = 0;            /**< Tekstura dla pakietów bez tekstury. */
+    std::vector<std::pair<const Shader*, const Shader*>> untexturedVariants; /**< Zamienniki programów dla pakietów bez tekstury. */
+
+    /**
+     * @brief Buduje 64-bitowy klucz sortowania pakietu.
+     */
+    uint64_t makeKey(RenderPass pass, const DrawPacket& packet, const glm::vec3& worldCenter) const;
+};
+
+#endif // RENDERQUEUE_H
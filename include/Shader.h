@@ -2,28 +2,70 @@
 #define SHADER_H
 
 #include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+/**
+ * @brief Zestaw definicji preprocesora (nazwa -> wartość) wstrzykiwanych do kodu shaderów.
+ *
+ * Uporządkowana mapa, więc ten sam zestaw zawsze daje ten sam tekst źródłowy i klucz permutacji.
+ */
+using ShaderDefines = std::map<std::string, int>;
+
+/**
+ * @enum ShaderBuild
+ * @brief Sposób budowania programu w konstruktorze Shader.
+ */
+enum class ShaderBuild {
+    Immediate,  /**< Konstruktor czeka na kompilację i linkowanie. */
+    Deferred    /**< Konstruktor tylko zleca pracę sterownikowi; wynik odbiera finishBuild()/pollCompletion(). */
+};
+
 /**
  * @class Shader
  * @brief Klasa obsługująca programy cieniujące w OpenGL.
  *
  * Klasa Shader umożliwia ładowanie, kompilację i używanie programów cieniujących
  * w OpenGL. Obsługuje zarówno podstawowy zestaw (vertex + fragment shader), jak
- * i opcjonalny geometry shader.
+ * i opcjonalny geometry shader. Przekazane definicje (ShaderDefines) wstawiane są jako
+ * dyrektywy #define zaraz po #version każdego etapu, co pozwala kompilować wyspecjalizowane
+ * warianty tego samego kodu (zob. ShaderPermutations).
+ *
+ * W trybie ShaderBuild::Deferred konstruktor zleca kompilację i linkowanie bez odpytywania
+ * statusu, więc sterownik (z GL_KHR_parallel_shader_compile - na wielu wątkach) pracuje
+ * w tle; błędy kompilacji zgłaszane są dopiero w finishBuild(). Zob. ShaderBatch.
+ *
+ * Zlinkowane programy zapisywane są na dysku (ProgramBinaryCache), więc kolejne
+ * uruchomienia z tym samym kodem i sterownikiem pomijają kompilację.
+ *
+ * Po zlinkowaniu program jest jednorazowo odpytywany o wszystkie aktywne uniformy
+ * (interfejs GL_UNIFORM), a ich lokalizacje trafiają do płaskiej, posortowanej tablicy.
+ * Kod renderujący pobiera uchwyty raz i ustawia wartości typowanymi setterami,
+ * bez wywołań glGetUniformLocation w pętli renderowania.
  */
 class Shader {
 public:
+    /**
+     * @brief Uchwyt do uniformu (lokalizacja w programie, -1 gdy uniform nie istnieje).
+     */
+    using UniformHandle = GLint;
+
     /**
      * @brief Konstruktor ładujący i kompilujący program cieniujący (vertex + fragment).
      *
      * @param vertexPath Ścieżka do pliku z kodem vertex shadera.
      * @param fragmentPath Ścieżka do pliku z kodem fragment shadera.
+     * @param defines Definicje preprocesora wstawiane do obu etapów.
+     * @param mode Tryb budowania programu.
      */
-    Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    Shader(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines = {},
+        ShaderBuild mode = ShaderBuild::Immediate);
 
     /**
      * @brief Konstruktor ładujący i kompilujący program cieniujący (vertex + fragment + geometry).
@@ -31,14 +73,38 @@ public:
      * @param vertexPath Ścieżka do pliku z kodem vertex shadera.
      * @param fragmentPath Ścieżka do pliku z kodem fragment shadera.
      * @param geometryPath Ścieżka do pliku z kodem geometry shadera.
+     * @param defines Definicje preprocesora wstawiane do wszystkich etapów.
+     * @param mode Tryb budowania programu.
      */
-    Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath);
+    Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath,
+        const ShaderDefines& defines = {}, ShaderBuild mode = ShaderBuild::Immediate);
 
     /**
      * @brief Destruktor zwalniający zasoby programu cieniującego.
      */
     ~Shader();
 
+    /**
+     * @brief Sprawdza bez blokowania, czy odroczone budowanie się zakończyło, i je finalizuje.
+     *
+     * Bez rozszerzenia równoległej kompilacji finalizuje program od razu (blokująco).
+     *
+     * @return true, jeśli program jest gotowy do użycia.
+     */
+    bool pollCompletion();
+
+    /**
+     * @brief Czeka na zakończenie odroczonego budowania, zgłasza błędy i odczytuje uniformy.
+     *
+     * Dla programu już gotowego nic nie robi.
+     */
+    void finishBuild();
+
+    /**
+     * @brief Sprawdza, czy program jest gotowy (zbudowany i sfinalizowany).
+     */
+    bool isReady() const { return ready; }
+
     /**
      * @brief Aktywuje program cieniujący w OpenGL.
      *
@@ -54,12 +120,101 @@ public:
      */
     GLuint getProgramID() const;
 
+    /**
+     * @brief Zwraca uchwyt uniformu o podanej nazwie.
+     *
+     * Wyszukiwanie binarne w tablicy zbudowanej przy linkowaniu; przeznaczone do
+     * jednorazowego rozwiązywania uchwytów, nie do wywoływania w każdej klatce.
+     * Elementy tablic dostępne są zarówno jako "nazwa[i]", jak i "nazwa" (element 0).
+     *
+     * @param name Nazwa uniformu w kodzie GLSL.
+     * @return Uchwyt uniformu lub -1, jeśli program go nie używa.
+     */
+    UniformHandle getUniform(const std::string& name) const;
+
+    /**
+     * @brief Ustawia uniform typu int (lub sampler) w tym programie.
+     *
+     * Settery korzystają z glProgramUniform*, więc nie wymagają aktywnego programu.
+     *
+     * @param handle Uchwyt uzyskany z getUniform().
+     * @param value Nowa wartość.
+     */
+    void setInt(UniformHandle handle, int value) const;
+
+    /**
+     * @brief Ustawia uniform typu float.
+     */
+    void setFloat(UniformHandle handle, float value) const;
+
+    /**
+     * @brief Ustawia uniform typu vec2.
+     */
+    void setVec2(UniformHandle handle, const glm::vec2& value) const;
+
+    /**
+     * @brief Ustawia uniform typu vec3.
+     */
+    void setVec3(UniformHandle handle, const glm::vec3& value) const;
+
+    /**
+     * @brief Ustawia uniform typu mat4.
+     */
+    void setMat4(UniformHandle handle, const glm::mat4& value) const;
+
 private:
+    /**
+     * @struct UniformInfo
+     * @brief Wpis tablicy uniformów odczytanej z programu.
+     */
+    struct UniformInfo {
+        std::string name;   /**< Pełna nazwa uniformu. */
+        GLint location;     /**< Lokalizacja w programie. */
+        GLenum type;        /**< Typ GLSL (np. GL_FLOAT_MAT4). */
+    };
+
     /**
      * @brief Identyfikator programu cieniującego OpenGL.
      */
     GLuint programID;
 
+    /**
+     * @brief Aktywne uniformy programu posortowane po nazwie.
+     */
+    std::vector<UniformInfo> uniforms;
+
+    std::vector<GLuint> pendingStages;  /**< Etapy czekające na sprawdzenie statusu kompilacji. */
+    uint64_t cacheKey = 0;              /**< Klucz w ProgramBinaryCache. */
+    bool storeInCache = false;          /**< Czy po udanym linkowaniu zapisać binarium. */
+    bool ready = false;                 /**< Czy program jest sfinalizowany. */
+
+    /**
+     * @brief Odczytuje aktywne uniformy programu i buduje tablicę uchwytów.
+     */
+    void reflectUniforms();
+
+    /**
+     * @brief Tworzy program z kodu źródłowego etapów.
+     *
+     * Najpierw próbuje wczytać binarium z ProgramBinaryCache; przy braku lub odrzuceniu
+     * wpisu zleca kompilację i linkowanie etapów. Sprawdzenie wyników i zapis binarium
+     * w pamięci podręcznej wykonuje finishBuild().
+     *
+     * @param stages Pary (typ etapu, kod źródłowy) w kolejności dołączania.
+     */
+    void buildProgram(const std::vector<std::pair<GLenum, std::string>>& stages);
+
+    /**
+     * @brief Wstawia definicje preprocesora za dyrektywą #version.
+     *
+     * Dodaje również "#line", aby numery linii w komunikatach błędów odpowiadały plikowi.
+     *
+     * @param source Kod źródłowy shadera.
+     * @param defines Definicje do wstawienia.
+     * @return Kod z definicjami.
+     */
+    static std::string injectDefines(const std::string& source, const ShaderDefines& defines);
+
     /**
      * @brief Wczytuje kod źródłowy shadera z pliku.
      *
@@ -69,11 +224,13 @@ private:
     std::string loadShaderFromFile(const std::string& filepath);
 
     /**
-     * @brief Kompiluje shader na podstawie kodu źródłowego.
+     * @brief Zleca kompilację shadera na podstawie kodu źródłowego.
+     *
+     * Status kompilacji nie jest odpytywany (to wymusiłoby czekanie); sprawdza go finishBuild().
      *
      * @param source Kod źródłowy shadera.
      * @param type Typ shadera (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER).
-     * @return Identyfikator skompilowanego shadera lub 0 w przypadku błędu.
+     * @return Identyfikator shadera.
      */
     GLuint compileShader(const std::string& source, GLenum type);
 };
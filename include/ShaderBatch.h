@@ -0,0 +1,71 @@
+#ifndef SHADERBATCH_H
+#define SHADERBATCH_H
+
+#include "Shader.h"
+#include <vector>
+
+/**
+ * @class ShaderBatch
+ * @brief Grupa programów budowanych równolegle w tle.
+ *
+ * Wszystkie programy są najpierw zlecane sterownikowi (ShaderBuild::Deferred), a dopiero
+ * potem odpytywane. Gdy sterownik obsługuje GL_KHR_parallel_shader_compile (lub wersję ARB),
+ * partia włącza maksymalną liczbę wątków kompilatora, a poll() sprawdza
+ * GL_COMPLETION_STATUS_KHR bez blokowania - w tym czasie można wczytywać zasoby sceny.
+ * Bez rozszerzenia poll() finalizuje programy blokująco - efekt jest taki sam jak
+ * przy budowaniu natychmiastowym, tylko odsunięty w czasie.
+ */
+class ShaderBatch {
+public:
+    /**
+     * @brief Tworzy pustą partię i włącza równoległą kompilację, jeśli jest dostępna.
+     */
+    ShaderBatch();
+
+    /**
+     * @brief Zleca zbudowanie programu (vertex + fragment).
+     *
+     * @param vertexPath Ścieżka do pliku z kodem vertex shadera.
+     * @param fragmentPath Ścieżka do pliku z kodem fragment shadera.
+     * @param defines Definicje preprocesora.
+     * @return Nowy program należący do wywołującego; gotowy po poll() == true albo wait().
+     */
+    Shader* add(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines = {});
+
+    /**
+     * @brief Zleca zbudowanie programu (vertex + fragment + geometry).
+     *
+     * @return Nowy program należący do wywołującego.
+     */
+    Shader* add(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath,
+        const ShaderDefines& defines = {});
+
+    /**
+     * @brief Dołącza do partii program utworzony w trybie ShaderBuild::Deferred.
+     *
+     * Program musi istnieć co najmniej do zakończenia partii.
+     */
+    void track(Shader& shader);
+
+    /**
+     * @brief Finalizuje programy, których budowanie się zakończyło.
+     *
+     * @return true, gdy w partii nie ma już programów w toku.
+     */
+    bool poll();
+
+    /**
+     * @brief Czeka na wszystkie programy partii.
+     */
+    void wait();
+
+    /**
+     * @brief Liczba programów w toku.
+     */
+    size_t pendingCount() const { return pending.size(); }
+
+private:
+    std::vector<Shader*> pending;  /**< Programy w toku (bez własności). */
+};
+
+#endif // SHADERBATCH_H
@@ -0,0 +1,66 @@
+#ifndef SHADERPERMUTATIONS_H
+#define SHADERPERMUTATIONS_H
+
+#include "Shader.h"
+#include "ShaderBatch.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class ShaderPermutations
+ * @brief Pamięć podręczna wyspecjalizowanych wariantów jednego programu cieniującego.
+ *
+ * Każdy zestaw definicji preprocesora (liczba świateł z cieniem, tryb debugowania,
+ * teksturowanie, klastry) to osobny program kompilowany przy pierwszym użyciu
+ * i przechowywany do końca działania. Rozgałęzienia sterowane tymi definicjami znikają
+ * w czasie kompilacji, więc kod renderujący wybiera wariant zamiast ustawiać uniformy
+ * sterujące gałęziami.
+ *
+ * Zwracane referencje pozostają ważne przez cały czas życia obiektu.
+ */
+class ShaderPermutations {
+public:
+    /**
+     * @brief Tworzy pustą pamięć wariantów dla pary plików shaderów.
+     *
+     * @param vertexPath Ścieżka do pliku z kodem vertex shadera.
+     * @param fragmentPath Ścieżka do pliku z kodem fragment shadera.
+     */
+    ShaderPermutations(const std::string& vertexPath, const std::string& fragmentPath);
+
+    /**
+     * @brief Zwraca wariant dla zestawu definicji, kompilując go przy pierwszym użyciu.
+     *
+     * @param defines Definicje preprocesora wariantu.
+     * @return Skompilowany program.
+     */
+    const Shader& get(const ShaderDefines& defines);
+
+    /**
+     * @brief Zleca zbudowanie wariantu w tle, jeśli jeszcze nie istnieje.
+     *
+     * Późniejsze get() zwraca ten sam program, w razie potrzeby czekając na jego ukończenie.
+     *
+     * @param defines Definicje preprocesora wariantu.
+     * @param batch Partia, do której trafia budowany program.
+     */
+    void request(const ShaderDefines& defines, ShaderBatch& batch);
+
+    /**
+     * @brief Liczba skompilowanych wariantów.
+     */
+    size_t size() const { return programs.size(); }
+
+private:
+    /**
+     * @brief Buduje klucz wariantu ("NAZWA=wartość;" dla każdej definicji, w kolejności nazw).
+     */
+    static std::string makeKey(const ShaderDefines& defines);
+
+    std::string vertexPath;    /**< Ścieżka vertex shadera. */
+    std::string fragmentPath;  /**< Ścieżka fragment shadera. */
+    std::unordered_map<std::string, std::unique_ptr<Shader>> programs; /**< Skompilowane warianty. */
+};
+
+#endif // SHADERPERMUTATIONS_H
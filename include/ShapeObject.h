@@ -32,14 +32,14 @@ public:
     virtual void setupBuffers() = 0;
 
     /**
-     * @brief Rysuje obiekt przy użyciu podanego programu cieniującego i macierzy transformacji.
+     * @brief Zgłasza obiekt do kolejki rysowania w podanym przebiegu.
      *
-     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param queue Kolejka rysowania bieżącej klatki.
+     * @param pass Przebieg, w którym obiekt ma zostać narysowany.
+     * @param shader Program cieniujący z rozwiązanymi uchwytami uniformów.
      * @param model Macierz modelu, określająca transformację obiektu w przestrzeni świata.
-     * @param view Macierz widoku, określająca pozycję kamery i jej orientację.
-     * @param projection Macierz projekcji, definiująca sposób odwzorowania 3D na 2D.
      */
-    virtual void draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) override = 0;
+    virtual void submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const override = 0;
 
     /**
      * @brief Przesuwa obiekt o podany wektor kierunku.
@@ -0,0 +1,178 @@
+#ifndef STATICGEOMETRY_H
+#define STATICGEOMETRY_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "MeshCache.h"
+#include "Wall.h"
+#include "Frustum.h"
+
+class ModelObject;
+
+/**
+ * @struct DrawElementsIndirectCommand
+ * @brief Polecenie rysowania w układzie wymaganym przez glMultiDrawElementsIndirect.
+ */
+struct DrawElementsIndirectCommand {
+    GLuint count;          /**< Liczba indeksów. */
+    GLuint instanceCount;  /**< Liczba instancji (zawsze 1). */
+    GLuint firstIndex;     /**< Pierwszy indeks w buforze indeksów areny. */
+    GLint baseVertex;      /**< Przesunięcie wierzchołków siatki w buforze areny. */
+    GLuint baseInstance;   /**< Indeks danych rysowania w buforze macierzy. */
+};
+
+/**
+ * @class StaticGeometry
+ * @brief Arena statycznej geometrii rysowana przez glMultiDrawElementsIndirect.
+ *
+ * Wszystkie nieruchome siatki (ściany, stoły, broń na ekspozycji) są raz, przy starcie,
+ * kopiowane do wspólnego bufora wierzchołków i indeksów. Każda siatka dostaje jedno
+ * polecenie pośrednie, a jej macierz modelu trafia do bufora danych rysowania pod
+ * indeksem równym baseInstance polecenia - shadery czytają ją tym samym atrybutem
+ * instancji co w kolejce renderowania. Polecenia są pogrupowane według trybu
+ * odrzucania ścian i tekstury, więc przebieg to jedno wywołanie na grupę.
+ *
+ * Ściany o tej samej teksturze są przy dodawaniu scalane w jedną siatkę, a ich
+ * prostopadłościany kolizji zbierane w jedną listę dla obserwatora - mapa złożona
+ * z setek fragmentów ścian kosztuje tyle poleceń, ile ma różnych tekstur.
+ *
+ * Bufor poleceń zawiera dwie kopie listy: pełną dla map cieni (obiekty poza kadrem
+ * nadal rzucają cień) i kopię dla przebiegu głównego, w której cull() zeruje
+ * instanceCount poleceń poza ostrosłupem widzenia.
+ */
+class StaticGeometry {
+public:
+    /**
+     * @brief Zwalnia bufory areny.
+     */
+    ~StaticGeometry();
+
+    /**
+     * @brief Dodaje ścianę do areny (wierzchołki ściany są już w przestrzeni świata).
+     *
+     * Ściana jest dołączana do scalonej siatki ścian o tej samej teksturze,
+     * a jej prostopadłościan trafia do listy kolizji.
+     *
+     * @param wall Ściana do dodania.
+     */
+    void addWall(const Wall& wall);
+
+    /**
+     * @brief Dodaje wszystkie siatki modelu z jego bieżącą macierzą modelu.
+     *
+     * @param model Obiekt modelu do dodania.
+     */
+    void addModel(const ModelObject& model);
+
+    /**
+     * @brief Tworzy bufory areny i bufor poleceń pośrednich z dodanych siatek.
+     *
+     * Wywoływane raz, po dodaniu całej statycznej geometrii.
+     */
+    void build();
+
+    /**
+     * @brief Usuwa zawartość areny.
+     */
+    void clear();
+
+    /**
+     * @brief Rysuje całą arenę w podanym przebiegu.
+     *
+     * @param pass Przebieg (decyduje o trybie odrzucania ścian).
+     * @param shader Program cieniujący przebiegu.
+     * @param untexturedShader Wariant dla grup bez własnej tekstury (nullptr = ten sam program).
+     */
+    void draw(RenderPass pass, const Shader& shader, const Shader* untexturedShader = nullptr) const;
+
+    /**
+     * @brief Odrzuca polecenia przebiegu głównego leżące poza ostrosłupem widzenia.
+     *
+     * Bufor poleceń jest aktualizowany tylko wtedy, gdy widoczność się zmieniła.
+     *
+     * @param frustum Ostrosłup widzenia kamery.
+     * @param stats Liczniki, do których dodawane są wyniki.
+     */
+    void cull(const Frustum& frustum, CullingStats& stats);
+
+    /**
+     * @brief Ustawia teksturę dla siatek bez własnej tekstury.
+     */
+    void setDefaultTexture(GLuint textureID);
+
+    /**
+     * @brief Zwraca liczbę poleceń rysowania w arenie.
+     */
+    size_t getDrawCount() const { return commands.size(); }
+
+    /**
+     * @brief Zwraca liczbę wywołań glMultiDrawElementsIndirect na przebieg.
+     */
+    size_t getGroupCount() const { return groups.size(); }
+
+    /**
+     * @brief Zwraca prostopadłościany kolizji dodanych ścian.
+     */
+    const std::vector<CollisionBox>& getCollisionBoxes() const { return collisionBoxes; }
+
+    /**
+     * @brief Sprawdza, czy arena zawiera geometrię gotową do rysowania.
+     */
+    bool isBuilt() const { return vao != 0 && !commands.empty(); }
+
+private:
+    /**
+     * @struct Source
+     * @brief Siatka zgłoszona do areny przed zbudowaniem buforów.
+     */
+    struct Source {
+        GLuint vbo = 0;                      /**< Bufor wierzchołków modelu (0 dla ścian). */
+        GLuint ebo = 0;                      /**< Bufor indeksów modelu (0 dla ścian). */
+        GLsizei vertexCount = 0;             /**< Liczba wierzchołków. */
+        GLsizei indexCount = 0;              /**< Liczba indeksów. */
+        GLenum indexType = GL_UNSIGNED_INT;  /**< Typ indeksów w buforze modelu. */
+        VertexQuantization quantization;     /**< Kwantyzacja pozycji siatki. */
+        std::vector<MeshVertex> vertices;    /**< Wierzchołki ściany. */
+        std::vector<unsigned int> indices;   /**< Indeksy ściany. */
+        GLuint texture = 0;                  /**< Tekstura siatki. */
+        bool doubleSided = false;            /**< Ściany rysowane bez odrzucania. */
+        glm::mat4 model{ 1.0f };             /**< Macierz modelu. */
+        BoundingSphere bounds;               /**< Sfera otaczająca w przestrzeni świata. */
+    };
+
+    /**
+     * @struct Group
+     * @brief Ciągły zakres poleceń o tym samym trybie odrzucania i teksturze.
+     */
+    struct Group {
+        bool doubleSided;   /**< Tryb odrzucania ścian. */
+        GLuint texture;     /**< Tekstura grupy. */
+        GLuint first;       /**< Pierwsze polecenie grupy. */
+        GLsizei count;      /**< Liczba poleceń. */
+    };
+
+    std::vector<Source> sources;                          /**< Siatki oczekujące na budowę. */
+    std::vector<DrawElementsIndirectCommand> commands;    /**< Polecenia w kolejności grup. */
+    std::vector<DrawElementsIndirectCommand> mainCommands; /**< Polecenia przebiegu głównego po odrzucaniu. */
+    std::vector<BoundingSphere> commandBounds;            /**< Sfery otaczające poleceń. */
+    std::vector<Group> groups;                            /**< Grupy poleceń. */
+    std::vector<CollisionBox> collisionBoxes;             /**< Kolizje ścian w przestrzeni świata. */
+
+    GLuint vao = 0;             /**< VAO areny. */
+    GLuint vertexBuffer = 0;    /**< Wspólny bufor wierzchołków. */
+    GLuint indexBuffer = 0;     /**< Wspólny bufor indeksów. */
+    GLuint drawDataBuffer = 0;  /**< Dane instancji (macierze modelu i normalnych) indeksowane przez baseInstance. */
+    GLuint indirectBuffer = 0;  /**< Bufor poleceń pośrednich. */
+    GLuint defaultTexture = 0;  /**< Tekstura dla siatek bez tekstury. */
+    GLenum indexType = GL_UNSIGNED_INT; /**< Typ indeksów wspólnego bufora. */
+
+    /**
+     * @brief Zwalnia obiekty OpenGL areny.
+     */
+    void releaseBuffers();
+};
+
+#endif // STATICGEOMETRY_H
@@ -10,11 +10,6 @@ public:
 
     bool isHitByRay(const glm::vec3& rayOrigin, const glm::vec3& rayDir) const;
     void onHit();
-
-
-    glm::vec3 bboxMin;
-    glm::vec3 bboxMax;
-    void calculateBoundingBox();
 };
 
 #endif // TARGET_OBJECT_H
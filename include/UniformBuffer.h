@@ -0,0 +1,122 @@
+#ifndef UNIFORMBUFFER_H
+#define UNIFORMBUFFER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * @brief Punkt wiązania bloku FrameData (macierze kamery, ustawienia klatki).
+ */
+constexpr GLuint FRAME_DATA_BINDING = 0;
+
+/**
+ * @brief Punkt wiązania bloku LightData (parametry świateł).
+ */
+constexpr GLuint LIGHT_DATA_BINDING = 1;
+
+/**
+ * @brief Maksymalna liczba świateł rzucających cień w bloku LightData (musi zgadzać się z shaderami).
+ *
+ * Światła bez cienia nie mają tego limitu - trafiają do bufora świateł klastrów (LightClusters).
+ */
+constexpr int MAX_SHADOW_LIGHTS = 10;
+
+/**
+ * @struct FrameData
+ * @brief Dane kamery wspólne dla całej klatki, układ std140.
+ */
+struct FrameData {
+    glm::mat4 view;          /**< Macierz widoku. */
+    glm::mat4 projection;    /**< Macierz projekcji. */
+    glm::vec3 viewPos;       /**< Pozycja kamery w przestrzeni świata. */
+    int padding;             /**< Wyrównanie do 16 bajtów. */
+    glm::uvec4 clusterGrid;  /**< Siatka klastrów świateł (x, y, z) i liczba świateł (w); z = 0 wyłącza klastry. */
+    glm::vec4 clusterParams; /**< Rozmiar kafelka w pikselach (x, y), skala i przesunięcie plastra (z, w). */
+};
+
+/**
+ * @struct GpuLight
+ * @brief Pojedyncze światło rzucające cień w bloku LightData, układ std140.
+ */
+struct GpuLight {
+    glm::vec4 position;          /**< Pozycja światła (xyz). */
+    glm::vec4 color;             /**< Kolor światła (rgb). */
+    glm::mat4 lightSpaceMatrix;  /**< Macierz przestrzeni światła. */
+};
+
+/**
+ * @struct LightData
+ * @brief Parametry świateł rzucających cień, układ std140.
+ */
+struct LightData {
+    int numLights;               /**< Liczba świateł rzucających cień (warstw map cieni). */
+    int padding[3];              /**< Wyrównanie tablicy struktur do 16 bajtów. */
+    GpuLight lights[MAX_SHADOW_LIGHTS]; /**< Tablica świateł. */
+};
+
+static_assert(sizeof(FrameData) == 176, "FrameData must match std140 layout");
+static_assert(sizeof(GpuLight) == 96, "GpuLight must match std140 layout");
+static_assert(sizeof(LightData) == 16 + 96 * MAX_SHADOW_LIGHTS, "LightData must match std140 layout");
+
+/**
+ * @class UniformBuffer
+ * @brief Bufor UBO przypięty do stałego punktu wiązania.
+ *
+ * Bufor może przechowywać kilka kopii bloku (slotów) wyrównanych do
+ * GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. Wszystkie sloty aktualizowane są jednym
+ * wywołaniem glBufferSubData, a przełączanie między nimi odbywa się przez
+ * glBindBufferRange, bez ponownego wysyłania danych.
+ */
+class UniformBuffer {
+public:
+    /**
+     * @brief Tworzy bufor i przypina slot 0 do punktu wiązania.
+     *
+     * @param binding Punkt wiązania bloku uniformów.
+     * @param blockSize Rozmiar pojedynczego bloku w bajtach.
+     * @param slotCount Liczba slotów przechowywanych w buforze.
+     */
+    UniformBuffer(GLuint binding, GLsizeiptr blockSize, int slotCount = 1);
+
+    /**
+     * @brief Zwalnia bufor OpenGL.
+     */
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    /**
+     * @brief Wysyła dane wszystkich slotów jednym wywołaniem.
+     *
+     * @param blocks Tablica kolejnych bloków (każdy o rozmiarze blockSize).
+     * @param count Liczba bloków do wysłania.
+     */
+    void upload(const void* blocks, int count);
+
+    /**
+     * @brief Wysyła początkowy fragment bloku w slocie 0.
+     *
+     * @param data Dane do wysłania.
+     * @param size Rozmiar danych w bajtach.
+     */
+    void uploadPartial(const void* data, GLsizeiptr size);
+
+    /**
+     * @brief Przypina wskazany slot do punktu wiązania.
+     *
+     * @param slot Indeks slotu.
+     */
+    void bindSlot(int slot) const;
+
+private:
+    GLuint bufferID = 0;     /**< Identyfikator bufora OpenGL. */
+    GLuint binding;          /**< Punkt wiązania bloku. */
+    GLsizeiptr blockSize;    /**< Rozmiar bloku w bajtach. */
+    GLsizeiptr slotStride;   /**< Odstęp między slotami (wyrównany). */
+    int slotCount;           /**< Liczba slotów. */
+    std::vector<unsigned char> staging; /**< Bufor pomocniczy do składania wyrównanych slotów. */
+};
+
+#endif // UNIFORMBUFFER_H
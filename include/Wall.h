@@ -7,6 +7,15 @@
 
 #include <iostream>
 
+/**
+ * @struct CollisionBox
+ * @brief Prostopadłościan kolizji (AABB) w przestrzeni świata.
+ */
+struct CollisionBox {
+    glm::vec3 min;  /**< Minimalny narożnik. */
+    glm::vec3 max;  /**< Maksymalny narożnik. */
+};
+
 /**
  * @class Wall
  * @brief Klasa reprezentująca ścianę jako obiekt 3D.
@@ -54,14 +63,21 @@ public:
     void setupBuffers();
 
     /**
-     * @brief Rysuje ścianę przy użyciu podanego programu cieniującego i macierzy transformacji.
+     * @brief Zgłasza ścianę do kolejki rysowania w podanym przebiegu.
      *
-     * @param shaderProgram Identyfikator programu cieniującego OpenGL.
+     * @param queue Kolejka rysowania bieżącej klatki.
+     * @param pass Przebieg, w którym obiekt ma zostać narysowany.
+     * @param shader Program cieniujący z rozwiązanymi uchwytami uniformów.
      * @param model Macierz modelu, określająca transformację obiektu w przestrzeni świata.
-     * @param view Macierz widoku, określająca pozycję kamery i jej orientację.
-     * @param projection Macierz projekcji, definiująca sposób odwzorowania 3D na 2D.
      */
-    void draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) override;
+    void submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const override;
+
+    /**
+     * @brief Zwraca sferę otaczającą (wierzchołki są już w przestrzeni świata).
+     *
+     * Wyznaczana ponownie tylko po transformacji.
+     */
+    BoundingSphere getBoundingSphere() const override;
 
     /**
      * @brief Przesuwa ścianę o podany wektor kierunku.
@@ -106,6 +122,26 @@ public:
     glm::vec3 getMinBounds() const;
     glm::vec3 getMaxBounds() const;
 
+    /**
+     * @brief Zwraca wierzchołki ściany (pozycja, współrzędne tekstury, normalna - 8 liczb na wierzchołek).
+     */
+    const std::vector<float>& getVertices() const { return vertices; }
+
+    /**
+     * @brief Zwraca indeksy trójkątów ściany.
+     */
+    const std::vector<unsigned int>& getIndices() const { return indices; }
+
+    /**
+     * @brief Zwraca identyfikator tekstury ściany.
+     */
+    GLuint getTextureID() const { return textureID; }
+
+    /**
+     * @brief Zwraca prostopadłościan kolizji ściany w przestrzeni świata.
+     */
+    CollisionBox getCollisionBox() const { return { getMinBounds(), getMaxBounds() }; }
+
 
 private:
     /**
@@ -137,6 +173,29 @@ private:
      * @brief Rozmiar ściany (szerokość, wysokość).
      */
     glm::vec2 size;
+
+    /**
+     * @brief Wierzchołki zmienione od ostatniego przesłania do VBO.
+     *
+     * Transformacje zmieniają tylko kopię CPU; bufor jest aktualizowany raz, przy
+     * pierwszym rysowaniu po zmianach, zamiast po każdej operacji ustawiania sceny.
+     */
+    mutable bool buffersDirty = false;
+
+    /**
+     * @brief Sfera otaczająca, wyznaczana leniwie po zmianie wierzchołków.
+     */
+    mutable BoundingSphere bounds;
+
+    /**
+     * @brief Sfera otaczająca wymaga ponownego wyznaczenia.
+     */
+    mutable bool boundsDirty = true;
+
+    /**
+     * @brief Przesyła zmienione wierzchołki do VBO, jeśli były modyfikowane.
+     */
+    void syncBuffers() const;
 };
 
 #endif // WALL_H
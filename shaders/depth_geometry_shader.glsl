@@ -0,0 +1,49 @@
+#version 430 core
+
+/**
+ * @brief Wejście: trójkąty w przestrzeni świata; jedno wywołanie shadera na każde możliwe światło.
+ */
+layout (triangles, invocations = 10) in;
+
+/**
+ * @brief Wyjście: ten sam trójkąt rzutowany do przestrzeni jednego światła.
+ */
+layout (triangle_strip, max_vertices = 3) out;
+
+/**
+ * @struct Light
+ * @brief Parametry pojedynczego źródła światła w bloku LightData.
+ */
+struct Light {
+    vec4 position;          /**< Pozycja światła (xyz). */
+    vec4 color;             /**< Kolor światła (rgb). */
+    mat4 lightSpaceMatrix;  /**< Macierz transformacji z przestrzeni świata do przestrzeni światła. */
+};
+
+/**
+ * @brief Parametry świateł sceny, wspólne z głównym programem.
+ */
+layout (std140, binding = 1) uniform LightData {
+    int numLights;      /**< Liczba aktywnych źródeł światła. */
+    Light lights[10];   /**< Tablica świateł. */
+};
+
+/**
+ * @brief Główna funkcja geometry shadera.
+ *
+ * Wywołanie o numerze i rzutuje trójkąt macierzą i-tego światła i kieruje go do
+ * warstwy i tablicy map cieni (gl_Layer), więc wszystkie mapy cieni powstają
+ * w jednym przejściu po scenie.
+ */
+void main() {
+    if (gl_InvocationID >= numLights) {
+        return;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        gl_Layer = gl_InvocationID;
+        gl_Position = lights[gl_InvocationID].lightSpaceMatrix * gl_in[i].gl_Position;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
@@ -6,24 +6,16 @@
 layout (location = 0) in vec3 aPos;
 
 /**
- * @brief Macierz transformacji z przestrzeni świata do przestrzeni światła.
- * 
- * Używana do przekształcenia pozycji wierzchołka, aby uzyskać współrzędne do generowania mapy cieni.
- */
-uniform mat4 lightSpaceMatrix;
-
-/**
- * @brief Macierz modelu, transformująca wierzchołek z przestrzeni lokalnej do przestrzeni świata.
+ * @brief Macierz modelu instancji (lokacje 3-6), transformująca wierzchołek z przestrzeni lokalnej do przestrzeni świata.
  */
-uniform mat4 model;
+layout (location = 3) in mat4 instanceModel;
 
 /**
  * @brief Główna funkcja vertex shadera.
  * 
- * Przekształca pozycję wierzchołka do przestrzeni światła, co jest wykorzystywane 
- * w shadow mappingu do obliczania cieni rzutowanych przez obiekty.
+ * Przekształca wierzchołek tylko do przestrzeni świata - rzutowanie do przestrzeni
+ * każdego ze świateł wykonuje geometry shader, osobno dla każdej warstwy mapy cieni.
  */
 void main() {
-    // Przekształcenie pozycji wierzchołka do przestrzeni światła
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = instanceModel * vec4(aPos, 1.0);
 }
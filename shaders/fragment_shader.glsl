@@ -1,5 +1,23 @@
 #version 430 core
 
+// Definicje wariantu wstawiane przez ShaderPermutations (wartości domyślne poniżej):
+// SHADOW_LIGHTS - liczba warstw map cieni (0 = bez cieni),
+// DEBUG_VIEW    - numer światła, którego cień jest wyświetlany (0 = wyłączony),
+// CLUSTERED     - 1 = światła z listy klastra, 0 = wszystkie światła (np. trzymana broń),
+// TEXTURED      - 1 = kolor z tekstury, 0 = biała powierzchnia.
+#ifndef SHADOW_LIGHTS
+#define SHADOW_LIGHTS 0
+#endif
+#ifndef DEBUG_VIEW
+#define DEBUG_VIEW 0
+#endif
+#ifndef CLUSTERED
+#define CLUSTERED 1
+#endif
+#ifndef TEXTURED
+#define TEXTURED 1
+#endif
+
 /**
  * @brief Pozycja fragmentu w przestrzeni świata.
  */
@@ -16,55 +34,87 @@ in vec3 Normal;
 in vec2 TexCoord;
 
 /**
- * @brief Pozycja fragmentu w przestrzeni światła dla wielu źródeł światła.
+ * @brief Dane kamery wspólne dla całej klatki (wypełniane raz na klatkę przez Engine).
  */
-in vec4 FragPosLightSpace[10];
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;        /**< Macierz widoku. */
+    mat4 projection;  /**< Macierz projekcji. */
+    vec3 viewPos;     /**< Pozycja widza/kamery w przestrzeni świata. */
+    uvec4 clusterGrid;   /**< Siatka klastrów (x, y, z) i liczba świateł (w). */
+    vec4 clusterParams;  /**< Rozmiar kafelka w pikselach (x, y), skala i przesunięcie plastra głębokości (z, w). */
+};
 
 /**
  * @struct Light
- * @brief Struktura reprezentująca pojedyncze źródło światła.
+ * @brief Światło rzucające cień (warstwa mapy cieni o tym samym indeksie).
  */
 struct Light {
+    vec4 position;          /**< Pozycja światła w przestrzeni świata (xyz). */
+    vec4 color;             /**< Kolor światła (rgb). */
+    mat4 lightSpaceMatrix;  /**< Macierz przestrzeni światła. */
+};
+
+/**
+ * @brief Światła rzucające cień.
+ */
+layout (std140, binding = 1) uniform LightData {
+    int numLights;      /**< Liczba warstw map cieni. */
+    Light lights[10];   /**< Tablica świateł. */
+};
+
+/**
+ * @struct PointLight
+ * @brief Światło punktowe z listy klastrów.
+ */
+struct PointLight {
     vec3 position;    /**< Pozycja światła w przestrzeni świata. */
-    vec3 color;       /**< Kolor światła. */
-    sampler2D shadowMap; /**< Mapa cieni przypisana do światła. */
+    float range;      /**< Zasięg światła. */
+    vec3 color;       /**< Kolor światła (rgb). */
+    int shadowLayer;  /**< Warstwa mapy cieni (-1 = bez cienia). */
 };
 
 /**
- * @brief Liczba aktywnych źródeł światła.
+ * @brief Wszystkie światła punktowe sceny.
  */
-uniform int numLights;
+layout (std430, binding = 2) readonly buffer PointLightData {
+    PointLight pointLights[];
+};
 
 /**
- * @brief Tablica świateł dostępnych w scenie.
+ * @brief Zakres listy świateł (początek, liczba) dla każdego klastra.
  */
-uniform Light lights[10];
+layout (std430, binding = 3) readonly buffer ClusterGrid {
+    uvec2 clusterRanges[];
+};
 
 /**
- * @brief Pozycja widza/kamery w przestrzeni świata.
+ * @brief Listy indeksów świateł wszystkich klastrów.
  */
-uniform vec3 viewPos;
+layout (std430, binding = 4) readonly buffer ClusterLightIndices {
+    uint clusterLightIndices[];
+};
 
 /**
- * @brief Tekstura używana do rysowania obiektu.
+ * @brief Mapy cieni wszystkich świateł (warstwa = indeks światła) z porównaniem głębokości.
  */
-uniform sampler2D texture1;
+layout (binding = 2) uniform sampler2DArrayShadow shadowMaps;
 
 /**
- * @brief Siła wpływu cienia na oświetlenie (wartość domyślna 1.5).
+ * @brief Tekstura używana do rysowania obiektu.
  */
-uniform float shadowStrength = 1.0;
+layout (binding = 0) uniform sampler2D texture1;
 
 /**
- * @brief Tryb debugowania (0 = wyłączony, wartości >0 wskazują konkretne źródło światła).
+ * @brief Siła wpływu cienia na oświetlenie (wartość domyślna 1.5).
  */
-uniform int debugMode = 0;
+uniform float shadowStrength = 1.0;
 
 /**
  * @brief Kolor wyjściowy piksela.
  */
 out vec4 FragColor;
 
+#if SHADOW_LIGHTS > 0
 /**
  * @brief Oblicza dynamiczne przesunięcie (bias) w celu redukcji artefaktów cieniowania.
  *
@@ -80,12 +130,12 @@ float computeBias(vec3 normal, vec3 lightDir) {
  * @brief Oblicza wartość cienia dla fragmentu.
  *
  * @param fragPosLight Pozycja fragmentu w przestrzeni światła.
- * @param shadowMap Mapa cieni przypisana do światła.
+ * @param layer Warstwa tablicy map cieni (indeks światła).
  * @param normal Wektor normalny powierzchni.
  * @param lightDir Kierunek do źródła światła.
  * @return Wartość cienia (1.0 = całkowicie zacienione, 0.0 = bez cienia).
  */
-float ShadowCalculation(vec4 fragPosLight, sampler2D shadowMap, vec3 normal, vec3 lightDir) {
+float ShadowCalculation(vec4 fragPosLight, int layer, vec3 normal, vec3 lightDir) {
     vec3 projCoords = fragPosLight.xyz / fragPosLight.w;  // Przekształcenie współrzędnych do przestrzeni NDC
     projCoords = projCoords * 0.5 + 0.5; // Przekształcenie do przedziału [0,1]
 
@@ -93,53 +143,117 @@ float ShadowCalculation(vec4 fragPosLight, sampler2D shadowMap, vec3 normal, vec
     if (projCoords.x < 0.0 || projCoords.x > 1.0 || projCoords.y < 0.0 || projCoords.y > 1.0 || projCoords.z > 1.0)
         return 0.0; 
 
-    float closestDepth = texture(shadowMap, projCoords.xy).r; // Pobranie głębokości zapisanej w mapie cieni
     float dynamicBias = computeBias(normal, lightDir);
 
-    // Jeśli aktualna głębokość jest większa niż zapisana w mapie + bias, piksel jest w cieniu
-    return projCoords.z > closestDepth + dynamicBias ? 1.0 : 0.0;
+    // Sprzętowe porównanie głębokości: 1.0, gdy fragment jest bliżej światła niż zapis w mapie
+    float lit = texture(shadowMaps, vec4(projCoords.xy, float(layer), projCoords.z - dynamicBias));
+    return 1.0 - lit;
 }
 
 /**
- * @brief Główna funkcja fragment shadera.
+ * @brief Oblicza wartość cienia fragmentu dla warstwy mapy cieni.
+ *
+ * @param layer Warstwa tablicy map cieni (indeks światła w bloku LightData).
+ * @param normal Wektor normalny powierzchni.
+ * @return Wartość cienia z przedziału [0,1].
  */
-void main() {
-    vec3 color = texture(texture1, TexCoord).rgb; // Pobranie koloru z tekstury
-    vec3 normal = normalize(Normal); // Normalizacja wektora normalnego
-    vec3 viewDir = normalize(viewPos - FragPos); // Kierunek do widza/kamery
-    vec3 result = vec3(0.0); // Inicjalizacja wyniku końcowego
+float shadowForLayer(int layer, vec3 normal) {
+    vec3 lightDir = normalize(lights[layer].position.xyz - FragPos);
+    vec4 fragPosLight = lights[layer].lightSpaceMatrix * vec4(FragPos, 1.0);
+    return clamp(ShadowCalculation(fragPosLight, layer, normal, lightDir), 0.0, 1.0);
+}
+#endif
 
-    for (int i = 0; i < numLights; ++i) {
-        vec3 lightDir = normalize(lights[i].position - FragPos); // Kierunek do światła
-        float distance = length(lights[i].position - FragPos); // Odległość od światła
-        float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.02 * (distance * distance)); // Współczynnik osłabienia
+/**
+ * @brief Oblicza wkład pojedynczego światła punktowego.
+ *
+ * Osłabienie jest wygaszane do zera na granicy zasięgu, więc pominięcie światła
+ * w klastrach poza zasięgiem nie zmienia wyniku.
+ *
+ * @param light Światło punktowe.
+ * @param color Kolor powierzchni z tekstury.
+ * @param normal Wektor normalny powierzchni.
+ * @param viewDir Kierunek do kamery.
+ * @return Składowe ambient, diffuse i specular z uwzględnieniem osłabienia i cienia.
+ */
+vec3 shadePointLight(PointLight light, vec3 color, vec3 normal, vec3 viewDir) {
+    vec3 lightDir = normalize(light.position - FragPos); // Kierunek do światła
+    float distance = length(light.position - FragPos); // Odległość od światła
+    float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.02 * (distance * distance)); // Współczynnik osłabienia
+    float falloff = clamp(1.0 - pow(distance / light.range, 4.0), 0.0, 1.0);
+    attenuation *= falloff * falloff;
 
-        // Składowa ambient (otoczenia)
-        vec3 ambient = 0.2 * lights[i].color * color;
+    // Składowa ambient (otoczenia)
+    vec3 ambient = 0.2 * light.color * color;
 
-        // Składowa diffuse (rozproszonego światła)
-        float diff = max(dot(normal, lightDir), 0.0);
-        vec3 diffuse = diff * lights[i].color * color;
+    // Składowa diffuse (rozproszonego światła)
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = diff * light.color * color;
 
-        // Składowa specular (odbicia)
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        float spec = pow(max(dot(normal, halfwayDir), 0.0), 16.0);
-        vec3 specular = vec3(0.3) * spec * lights[i].color;
+    // Składowa specular (odbicia)
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), 16.0);
+    vec3 specular = vec3(0.3) * spec * light.color;
 
-        // Obliczenie wartości cienia
-        float shadow = ShadowCalculation(FragPosLightSpace[i], lights[i].shadowMap, normal, lightDir);
-        shadow = clamp(shadow, 0.0, 1.0); // Ograniczenie wartości do przedziału [0,1]
+#if SHADOW_LIGHTS > 0
+    // Obliczenie wartości cienia (tylko światła z warstwą mapy cieni)
+    float shadow = 0.0;
+    if (light.shadowLayer >= 0) {
+        shadow = clamp(ShadowCalculation(lights[light.shadowLayer].lightSpaceMatrix * vec4(FragPos, 1.0),
+            light.shadowLayer, normal, lightDir), 0.0, 1.0);
+    }
 
-        // Tryb debugowania: jeśli wybrano konkretne światło, zwróć wartość cienia
-        if (debugMode == i+1) { 
-            FragColor = vec4(vec3(shadow), 1.0); 
-            return; 
-        }
+    // Sumowanie składowych z uwzględnieniem osłabienia i wpływu cieni
+    return (ambient + (1.0 - shadow * shadowStrength) * (diffuse + specular)) * attenuation;
+#else
+    return (ambient + diffuse + specular) * attenuation;
+#endif
+}
 
-        // Sumowanie składowych z uwzględnieniem osłabienia i wpływu cieni
-        result += (ambient + (1.0 - shadow * shadowStrength) * (diffuse + specular)) * attenuation;
+#if CLUSTERED
+/**
+ * @brief Wyznacza indeks klastra fragmentu z jego pozycji na ekranie i głębokości widoku.
+ */
+uint clusterIndex() {
+    float depth = max(-(view * vec4(FragPos, 1.0)).z, 1e-4);
+    uint slice = uint(max(log(depth) * clusterParams.z - clusterParams.w, 0.0));
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusterParams.xy);
+    tile = min(tile, clusterGrid.xy - 1u);
+    slice = min(slice, clusterGrid.z - 1u);
+    return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * slice);
+}
+#endif
+
+/**
+ * @brief Główna funkcja fragment shadera.
+ */
+void main() {
+#if TEXTURED
+    vec3 color = texture(texture1, TexCoord).rgb; // Pobranie koloru z tekstury
+#else
+    vec3 color = vec3(1.0);
+#endif
+    vec3 normal = normalize(Normal); // Normalizacja wektora normalnego
+
+#if DEBUG_VIEW > 0 && DEBUG_VIEW <= SHADOW_LIGHTS
+    // Tryb debugowania: wartość cienia wybranego światła zamiast oświetlenia
+    FragColor = vec4(vec3(shadowForLayer(DEBUG_VIEW - 1, normal)), 1.0);
+#else
+    vec3 viewDir = normalize(viewPos - FragPos); // Kierunek do widza/kamery
+    vec3 result = vec3(0.0); // Inicjalizacja wyniku końcowego
+
+#if CLUSTERED
+    uvec2 range = clusterRanges[clusterIndex()];
+    for (uint i = 0u; i < range.y; ++i) {
+        result += shadePointLight(pointLights[clusterLightIndices[range.x + i]], color, normal, viewDir);
+    }
+#else
+    for (uint i = 0u; i < clusterGrid.w; ++i) {
+        result += shadePointLight(pointLights[i], color, normal, viewDir);
     }
+#endif
 
     // Ustawienie koloru piksela
     FragColor = vec4(result, 1.0);
+#endif
 }
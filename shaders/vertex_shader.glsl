@@ -2,8 +2,12 @@
 
 /**
  * @brief Pozycja wierzchołka w przestrzeni lokalnej.
+ *
+ * Dla wierzchołków skompresowanych (PackedVertex) pozycja jest znormalizowana do AABB
+ * siatki (odwzorowanie zawiera macierz instancji), a w = 0 oznacza, że normalna
+ * zakodowana jest oktaedrycznie. Wierzchołki w pełnej precyzji mają w = 1.
  */
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec4 aPos;
 
 /**
  * @brief Współrzędne tekstury wierzchołka.
@@ -11,36 +15,30 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
 /**
- * @brief Wektor normalny wierzchołka.
+ * @brief Wektor normalny wierzchołka (xy kodowania oktaedrycznego dla wierzchołków skompresowanych).
  */
 layout (location = 2) in vec3 aNormal;
 
 /**
- * @brief Macierz modelu, transformująca wierzchołek do przestrzeni świata.
+ * @brief Macierz modelu instancji (lokacje 3-6), pobierana z bufora instancji kolejki renderowania.
  */
-uniform mat4 model;
+layout (location = 3) in mat4 instanceModel;
 
 /**
- * @brief Macierz widoku, określająca pozycję i orientację kamery.
+ * @brief Macierz normalnych instancji (lokacje 7-9), liczona raz na obiekt na CPU.
  */
-uniform mat4 view;
+layout (location = 7) in mat3 instanceNormalMatrix;
 
 /**
- * @brief Macierz projekcji, używana do transformacji do przestrzeni NDC (Normalized Device Coordinates).
+ * @brief Dane kamery wspólne dla całej klatki (wypełniane raz na klatkę przez Engine).
  */
-uniform mat4 projection;
-
-/**
- * @brief Macierze przestrzeni światła dla maksymalnie 10 źródeł światła.
- * 
- * Służą do transformacji pozycji fragmentu do przestrzeni światła, co jest używane do obliczania cieni.
- */
-uniform mat4 lightSpaceMatrix[10];
-
-/**
- * @brief Liczba aktywnych źródeł światła.
- */
-uniform int numLights;
+layout (std140, binding = 0) uniform FrameData {
+    mat4 view;        /**< Macierz widoku. */
+    mat4 projection;  /**< Macierz projekcji. */
+    vec3 viewPos;     /**< Pozycja kamery w przestrzeni świata. */
+    uvec4 clusterGrid;   /**< Siatka klastrów świateł i liczba świateł. */
+    vec4 clusterParams;  /**< Parametry wyszukiwania klastra. */
+};
 
 /**
  * @brief Pozycja fragmentu w przestrzeni świata.
@@ -58,28 +56,30 @@ out vec3 Normal;
 out vec2 TexCoord;
 
 /**
- * @brief Pozycja fragmentu w przestrzeni światła dla każdego źródła światła.
+ * @brief Dekoduje wektor jednostkowy zakodowany na ośmiościanie.
  */
-out vec4 FragPosLightSpace[10];
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 /**
  * @brief Główna funkcja vertex shadera.
  */
 void main() {
     // Transformacja pozycji wierzchołka do przestrzeni świata
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(instanceModel * vec4(aPos.xyz, 1.0));
 
-    // Transformacja normalnych do przestrzeni świata (prawidłowa obsługa skalowania)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Transformacja normalnych do przestrzeni świata (macierz z bufora instancji obsługuje niejednolitą skalę)
+    vec3 normal = aPos.w == 0.0 ? decodeOctahedral(aNormal.xy) : aNormal;
+    Normal = instanceNormalMatrix * normal;
 
     // Przekazanie współrzędnych tekstury
     TexCoord = aTexCoord;
 
-    // Transformacja pozycji fragmentu do przestrzeni światła dla każdego źródła światła
-    for (int i = 0; i < numLights; ++i) {
-        FragPosLightSpace[i] = lightSpaceMatrix[i] * vec4(FragPos, 1.0);
-    }
-
     // Transformacja pozycji wierzchołka do przestrzeni NDC
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -0,0 +1,110 @@
+#include "AssetLoader.h"
+#include <algorithm>
+#include <chrono>
+
+AssetLoader::AssetLoader(unsigned int threadCount)
+    : head(&stub), tail(&stub) {
+    if (threadCount == 0) {
+        // Jeden rdzeń zostaje dla wątku renderowania
+        threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    while (Node* node = pop()) {
+        delete node;
+    }
+}
+
+void AssetLoader::enqueue(Job job) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void AssetLoader::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Node* node = new Node();
+        node->completion = job();
+        push(node);
+    }
+}
+
+bool AssetLoader::pump(double budgetMs) {
+    auto start = std::chrono::steady_clock::now();
+    while (Node* node = pop()) {
+        if (node->completion) {
+            node->completion();
+        }
+        delete node;
+        pending.fetch_sub(1, std::memory_order_relaxed);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs) {
+            break;
+        }
+    }
+    return pendingCount() == 0;
+}
+
+void AssetLoader::push(Node* node) {
+    // Kolejka Vyukova: producent podmienia głowę jedną operacją atomową i dopiero
+    // potem dowiązuje poprzednika, więc konsument może chwilowo widzieć przerwę
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+AssetLoader::Node* AssetLoader::pop() {
+    Node* first = tail;
+    Node* next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail = next;
+        return first;
+    }
+    if (first != head.load(std::memory_order_acquire)) {
+        // Producent jest w trakcie dowiązywania - węzeł zostanie odebrany w następnym pump()
+        return nullptr;
+    }
+    push(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+    return nullptr;
+}
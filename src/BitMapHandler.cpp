@@ -1,51 +1,345 @@
 #include "BitmapHandler.h"
+#include "AssetLoader.h"
+#include "CookedTexture.h"
+#include "MipChain.h"
+#include "PixelUploadRing.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include <filesystem>
+#include <memory>
+
+std::unordered_map<std::string, BitmapHandler::CacheEntry> BitmapHandler::cache;
+std::unordered_map<GLuint, std::string> BitmapHandler::cacheKeys;
+TextureCacheStats BitmapHandler::stats;
+AssetLoader* BitmapHandler::loader = nullptr;
+PixelUploadRing* BitmapHandler::uploadRing = nullptr;
+std::deque<BitmapHandler::PendingUpload> BitmapHandler::pendingUploads;
+
+/**
+ * Tekstura gotowa do przesłania: skompresowana ze zmapowanego pliku albo zdekodowana.
+ */
+struct TextureSource {
+    MappedFile file;
+    CompressedTexture compressed;
+    MipChain chain;
+};
+
+namespace {
+    /**
+     * Wczytuje teksturę - z pliku przetworzonego, a gdy go brak, dekoduje obraz i buduje
+     * łańcuch mipmap; bezpieczne w wątkach roboczych.
+     */
+    bool loadImage(const std::string& filename, TextureSource& source) {
+        std::string cookedPath = CookedTexture::pathFor(filename);
+        if (GLEW_EXT_texture_compression_s3tc && CookedTexture::isFresh(cookedPath, filename)) {
+            if (source.file.open(cookedPath) && CookedTexture::read(source.file, source.compressed)) {
+                return true;
+            }
+            source.file.close();
+            source.compressed = CompressedTexture();
+        }
+
+        // Ustawienie globalne nie jest bezpieczne przy dekodowaniu w kilku wątkach naraz
+        stbi_set_flip_vertically_on_load_thread(true);
+        int width, height, channels;
+        unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 0);
+        if (!data) {
+            std::cerr << "Failed to load texture: " << filename << std::endl;
+            return false;
+        }
+        MipChain::build(data, width, height, channels, source.chain);
+        stbi_image_free(data);
+        return true;
+    }
+
+    GLenum formatFor(int channels) {
+        switch (channels) {
+        case 1: return GL_RED;
+        case 2: return GL_RG;
+        case 4: return GL_RGBA;
+        default: return GL_RGB;
+        }
+    }
+
+    GLenum internalFormatFor(int channels) {
+        switch (channels) {
+        case 1: return GL_R8;
+        case 2: return GL_RG8;
+        case 4: return GL_RGBA8;
+        default: return GL_RGB8;
+        }
+    }
+
+    const std::vector<MipLevel>& levelsOf(const TextureSource& source) {
+        return source.compressed.levels.empty() ? source.chain.levels : source.compressed.levels;
+    }
+
+    const unsigned char* levelData(const TextureSource& source, size_t level) {
+        if (!source.compressed.levels.empty()) {
+            return source.compressed.data + source.compressed.levels[level].offset;
+        }
+        return source.chain.levelData(level);
+    }
+
+    /**
+     * Rozmiar całego łańcucha mipmap w VRAM.
+     */
+    size_t sourceBytes(const TextureSource& source) {
+        size_t bytes = 0;
+        for (const MipLevel& mip : levelsOf(source)) {
+            bytes += mip.size;
+        }
+        return bytes;
+    }
+
+    /**
+     * Ustawia parametry przypiętej tekstury i tworzy niezmienny magazyn na cały łańcuch mipmap.
+     */
+    void allocateStorage(const TextureSource& source) {
+        const std::vector<MipLevel>& levels = levelsOf(source);
+        GLenum internalFormat = source.compressed.levels.empty() ? internalFormatFor(source.chain.channels) : source.compressed.format;
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levels.size()), internalFormat, levels[0].width, levels[0].height);
+        if (source.compressed.levels.empty() && source.chain.channels <= 2) {
+            // Jasność (z kanałem alfa przy 2 kanałach) rozprowadzona na RGB - tak samo jak w TextureCooker
+            const GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, source.chain.channels == 2 ? GL_GREEN : GL_ONE };
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+    }
+
+    /**
+     * Przesyła jeden poziom do przypiętej tekstury. pixels wskazuje na pamięć klienta
+     * albo jest przesunięciem w przypiętym GL_PIXEL_UNPACK_BUFFER.
+     */
+    void uploadLevel(const TextureSource& source, GLint level, const void* pixels) {
+        const MipLevel& mip = levelsOf(source)[level];
+        if (!source.compressed.levels.empty()) {
+            // Bloki BC z mipmapami z pliku trafiają na GPU bez dekodowania
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, mip.width, mip.height, source.compressed.format,
+                static_cast<GLsizei>(mip.size), pixels);
+        }
+        else {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, mip.width, mip.height, formatFor(source.chain.channels), GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+
+    void logLoaded(GLuint textureID, const std::string& filename, const TextureSource& source) {
+        const std::vector<MipLevel>& levels = levelsOf(source);
+        const char* formatName;
+        if (!source.compressed.levels.empty()) {
+            formatName = source.compressed.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? "BC1" : "BC3";
+        }
+        else {
+            static const char* const names[] = { "R", "RG", "RGB", "RGBA" };
+            formatName = names[source.chain.channels - 1];
+        }
+
+        std::cout << "Loaded texture: " << filename
+            << " [ID: " << textureID
+            << ", Format: " << formatName
+            << ", Size: " << levels[0].width << "x" << levels[0].height
+            << ", Mip levels: " << levels.size()
+            << "]" << std::endl;
+    }
+
+    /**
+     * Przesyła cały łańcuch mipmap do tekstury z pamięci klienta i zwraca jego rozmiar w VRAM.
+     */
+    size_t storeImage(GLuint textureID, const std::string& filename, const TextureSource& source) {
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        // Mipmapy zbudowane na CPU - bez glGenerateMipmap i oczekiwania na GPU przy starcie
+        allocateStorage(source);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (size_t level = 0; level < levelsOf(source).size(); ++level) {
+            uploadLevel(source, static_cast<GLint>(level), levelData(source, level));
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        logLoaded(textureID, filename, source);
+        return sourceBytes(source);
+    }
+}
 
 GLuint BitmapHandler::loadBitmapFromFile(const std::string& filename) {
-    int width, height, channels;
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(filename, ec);
+    std::string key = ec ? filename : canonical.generic_string();
 
-    stbi_set_flip_vertically_on_load(true); 
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 0);
-    if (!data) {
-        std::cerr << "Failed to load texture: " << filename << std::endl;
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        ++it->second.refCount;
+        ++stats.hits;
+        return it->second.textureID;
+    }
+
+    ++stats.misses;
+
+    size_t bytes = 0;
+    GLuint textureID = loader ? loadBitmapAsync(filename, key, bytes) : uploadBitmapFromFile(filename, bytes);
+    if (!textureID) {
         return 0;
     }
 
-    GLenum format = GL_RGB;
-    if (channels == 4) {
-        format = GL_RGBA;
+    CacheEntry& entry = cache[key];
+    entry.textureID = textureID;
+    entry.refCount = 1;
+    entry.bytes = bytes;
+    cacheKeys[textureID] = key;
+
+    ++stats.residentTextures;
+    stats.residentBytes += bytes;
+
+    return textureID;
+}
+
+void BitmapHandler::releaseBitmap(GLuint textureID) {
+    auto keyIt = cacheKeys.find(textureID);
+    if (keyIt == cacheKeys.end()) {
+        std::cerr << "releaseBitmap: texture " << textureID << " is not managed by the cache" << std::endl;
+        return;
     }
-    else if (channels == 1) {
-        format = GL_RED;
+
+    auto it = cache.find(keyIt->second);
+    if (--it->second.refCount > 0) {
+        return;
+    }
+
+    --stats.residentTextures;
+    stats.residentBytes -= it->second.bytes;
+
+    deleteBitmap(textureID);
+    cache.erase(it);
+    cacheKeys.erase(keyIt);
+}
+
+TextureCacheStats BitmapHandler::getCacheStats() {
+    return stats;
+}
+
+GLuint BitmapHandler::uploadBitmapFromFile(const std::string& filename, size_t& bytes) {
+    TextureSource source;
+    if (!loadImage(filename, source)) {
+        return 0;
     }
 
     GLuint textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    bytes = storeImage(textureID, filename, source);
+    return textureID;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+GLuint BitmapHandler::loadBitmapAsync(const std::string& filename, const std::string& key, size_t& bytes) {
+    GLuint textureID = createBitmap(1, 1, 255, 255, 255);
+    bytes = 3;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    loader->enqueue([filename, key, textureID]() -> AssetLoader::Completion {
+        auto source = std::make_shared<TextureSource>();
+        if (!loadImage(filename, *source)) {
+            return nullptr;
+        }
+        return [filename, key, textureID, source]() {
+            // Tekstura mogła zostać zwolniona, zanim obraz był gotowy
+            auto it = cache.find(key);
+            if (it == cache.end() || it->second.textureID != textureID) {
+                return;
+            }
+            if (uploadRing) {
+                int lastLevel = static_cast<int>(levelsOf(*source).size()) - 1;
+                pendingUploads.push_back({ key, textureID, filename, source, lastLevel });
+                return;
+            }
+            size_t bytes = storeImage(textureID, filename, *source);
+            stats.residentBytes += bytes - it->second.bytes;
+            it->second.bytes = bytes;
+        };
+    });
+    return textureID;
+}
 
-    
+void BitmapHandler::setLoader(AssetLoader* assetLoader) {
+    loader = assetLoader;
+}
 
-    glGenerateMipmap(GL_TEXTURE_2D); 
+void BitmapHandler::setUploadRing(PixelUploadRing* ring) {
+    uploadRing = ring;
+    if (!ring) {
+        pendingUploads.clear();
+    }
+}
 
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+void BitmapHandler::streamUploads(size_t budgetBytes) {
+    if (!uploadRing) {
+        return;
+    }
+    uploadRing->reclaim();
 
-    std::cout << "Loaded texture: " << filename
-        << " [ID: " << textureID
-        << ", Format: " << (format == GL_RGBA ? "RGBA" : "RGB")
-        << ", Size: " << width << "x" << height
-        << "]" << std::endl;
+    size_t uploaded = 0;
+    bool stalled = false;
+    while (!pendingUploads.empty() && !stalled) {
+        PendingUpload& upload = pendingUploads.front();
+        auto it = cache.find(upload.key);
+        if (it == cache.end() || it->second.textureID != upload.textureID) {
+            pendingUploads.pop_front();
+            continue;
+        }
 
-    return textureID;
+        const TextureSource& source = *upload.source;
+        const std::vector<MipLevel>& levels = levelsOf(source);
+        glBindTexture(GL_TEXTURE_2D, upload.textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        // Od najmniejszego poziomu: tekstura jest kompletna po każdym kroku i wyostrza się z kolejnymi klatkami
+        while (upload.nextLevel >= 0) {
+            const MipLevel& mip = levels[upload.nextLevel];
+            if (uploaded > 0 && uploaded + mip.size > budgetBytes) {
+                stalled = true;
+                break;
+            }
+
+            const void* pixels = levelData(source, upload.nextLevel);
+            size_t offset;
+            if (mip.size > uploadRing->getCapacity()) {
+                // Poziom większy niż cały pierścień - przesyłany bezpośrednio z pamięci klienta
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            else if (uploadRing->write(pixels, mip.size, offset)) {
+                uploadRing->bind();
+                pixels = reinterpret_cast<const void*>(offset);
+            }
+            else {
+                // Pierścień zajęty przez przesyłanie, którego GPU jeszcze nie wykonało
+                stalled = true;
+                break;
+            }
+
+            if (!upload.started) {
+                allocateStorage(source);
+                size_t bytes = sourceBytes(source);
+                stats.residentBytes += bytes - it->second.bytes;
+                it->second.bytes = bytes;
+                upload.started = true;
+            }
+            uploadLevel(source, upload.nextLevel, pixels);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, upload.nextLevel);
+            uploaded += mip.size;
+            --upload.nextLevel;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (upload.nextLevel < 0) {
+            logLoaded(upload.textureID, upload.filename, source);
+            pendingUploads.pop_front();
+        }
+    }
+
+    uploadRing->fence();
 }
 
 GLuint BitmapHandler::createBitmap(int width, int height, unsigned char r, unsigned char g, unsigned char b) {
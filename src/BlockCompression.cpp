@@ -0,0 +1,217 @@
+#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    uint16_t packColor565(const float color[3]) {
+        int r = std::clamp(static_cast<int>(std::lround(color[0] * 31.0f / 255.0f)), 0, 31);
+        int g = std::clamp(static_cast<int>(std::lround(color[1] * 63.0f / 255.0f)), 0, 63);
+        int b = std::clamp(static_cast<int>(std::lround(color[2] * 31.0f / 255.0f)), 0, 31);
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    void unpackColor565(uint16_t packed, int color[3]) {
+        int r = packed >> 11 & 31;
+        int g = packed >> 5 & 63;
+        int b = packed & 31;
+        color[0] = r << 3 | r >> 2;
+        color[1] = g << 2 | g >> 4;
+        color[2] = b << 3 | b >> 2;
+    }
+
+    void writeLittleEndian(uint8_t* out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    /**
+     * Koduje kolor bloku w formacie BC1 (zawsze tryb czterech kolorów).
+     */
+    void encodeColor(const uint8_t rgba[64], uint8_t out[8]) {
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                mean[c] += rgba[i * 4 + c];
+            }
+        }
+        for (float& value : mean) {
+            value /= 16.0f;
+        }
+
+        float covariance[6] = { 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            float r = rgba[i * 4] - mean[0];
+            float g = rgba[i * 4 + 1] - mean[1];
+            float b = rgba[i * 4 + 2] - mean[2];
+            covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+            covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+        }
+
+        // Główna oś rozrzutu kolorów - kilka kroków iteracji potęgowej wystarcza. Start od kanału
+        // o największej wariancji: stała oś (1,1,1) bywa prostopadła do rozrzutu (np. czerwony/zielony)
+        int largest = covariance[0] >= covariance[3] ? (covariance[0] >= covariance[5] ? 0 : 2) : (covariance[3] >= covariance[5] ? 1 : 2);
+        float axis[3] = { 0.0f, 0.0f, 0.0f };
+        axis[largest] = 1.0f;
+        bool degenerate = false;
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            float next[3] = {
+                covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+            };
+            float length = std::max(std::abs(next[0]), std::max(std::abs(next[1]), std::abs(next[2])));
+            if (length < 1e-6f) {
+                degenerate = iteration == 0;
+                break;
+            }
+            for (int c = 0; c < 3; ++c) {
+                axis[c] = next[c] / length;
+            }
+        }
+        if (degenerate) {
+            // Brak rozrzutu - końce według jasności
+            axis[0] = 0.299f;
+            axis[1] = 0.587f;
+            axis[2] = 0.114f;
+        }
+
+        int minIndex = 0;
+        int maxIndex = 0;
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            float projection = rgba[i * 4] * axis[0] + rgba[i * 4 + 1] * axis[1] + rgba[i * 4 + 2] * axis[2];
+            if (i == 0 || projection < minProjection) {
+                minProjection = projection;
+                minIndex = i;
+            }
+            if (i == 0 || projection > maxProjection) {
+                maxProjection = projection;
+                maxIndex = i;
+            }
+        }
+
+        float maxColor[3] = { float(rgba[maxIndex * 4]), float(rgba[maxIndex * 4 + 1]), float(rgba[maxIndex * 4 + 2]) };
+        float minColor[3] = { float(rgba[minIndex * 4]), float(rgba[minIndex * 4 + 1]), float(rgba[minIndex * 4 + 2]) };
+        uint16_t color0 = packColor565(maxColor);
+        uint16_t color1 = packColor565(minColor);
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        uint32_t indices = 0;
+        if (color0 != color1) {
+            // color0 > color1 wybiera tryb czterech kolorów bez przezroczystości
+            int palette[4][3];
+            unpackColor565(color0, palette[0]);
+            unpackColor565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (int i = 0; i < 16; ++i) {
+                int best = 0;
+                int bestDistance = INT32_MAX;
+                for (int p = 0; p < 4; ++p) {
+                    int dr = rgba[i * 4] - palette[p][0];
+                    int dg = rgba[i * 4 + 1] - palette[p][1];
+                    int db = rgba[i * 4 + 2] - palette[p][2];
+                    int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint32_t>(best) << (2 * i);
+            }
+        }
+
+        writeLittleEndian(out, color0, 2);
+        writeLittleEndian(out + 2, color1, 2);
+        writeLittleEndian(out + 4, indices, 4);
+    }
+
+    /**
+     * Koduje kanał alfa bloku BC3 (tryb ośmiu wartości).
+     */
+    void encodeAlpha(const uint8_t rgba[64], uint8_t out[8]) {
+        int alpha0 = 0;
+        int alpha1 = 255;
+        for (int i = 0; i < 16; ++i) {
+            alpha0 = std::max(alpha0, static_cast<int>(rgba[i * 4 + 3]));
+            alpha1 = std::min(alpha1, static_cast<int>(rgba[i * 4 + 3]));
+        }
+
+        uint64_t indices = 0;
+        if (alpha0 != alpha1) {
+            int palette[8] = { alpha0, alpha1 };
+            for (int p = 1; p < 7; ++p) {
+                palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+            }
+            for (int i = 0; i < 16; ++i) {
+                int best = 0;
+                int bestDistance = 256;
+                for (int p = 0; p < 8; ++p) {
+                    int distance = std::abs(rgba[i * 4 + 3] - palette[p]);
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(alpha0);
+        out[1] = static_cast<uint8_t>(alpha1);
+        writeLittleEndian(out + 2, indices, 6);
+    }
+}
+
+size_t BlockCompression::imageBytes(BlockFormat format, int width, int height) {
+    size_t blocksX = static_cast<size_t>(std::max(1, (width + 3) / 4));
+    size_t blocksY = static_cast<size_t>(std::max(1, (height + 3) / 4));
+    return blocksX * blocksY * blockBytes(format);
+}
+
+void BlockCompression::encodeBlock(const uint8_t rgba[64], BlockFormat format, uint8_t* out) {
+    if (format == BlockFormat::BC3) {
+        encodeAlpha(rgba, out);
+        out += 8;
+    }
+    encodeColor(rgba, out);
+}
+
+void BlockCompression::compress(const unsigned char* pixels, int width, int height, int channels, BlockFormat format,
+    std::vector<uint8_t>& out) {
+    size_t start = out.size();
+    out.resize(start + imageBytes(format, width, height));
+    uint8_t* block = out.data() + start;
+
+    uint8_t rgba[64];
+    for (int blockY = 0; blockY < height; blockY += 4) {
+        for (int blockX = 0; blockX < width; blockX += 4) {
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    int sourceX = std::min(blockX + x, width - 1);
+                    int sourceY = std::min(blockY + y, height - 1);
+                    const unsigned char* pixel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * channels;
+                    uint8_t* target = rgba + (y * 4 + x) * 4;
+                    if (channels >= 3) {
+                        target[0] = pixel[0];
+                        target[1] = pixel[1];
+                        target[2] = pixel[2];
+                        target[3] = channels == 4 ? pixel[3] : 255;
+                    }
+                    else {
+                        target[0] = target[1] = target[2] = pixel[0];
+                        target[3] = channels == 2 ? pixel[1] : 255;
+                    }
+                }
+            }
+            encodeBlock(rgba, format, block);
+            block += blockBytes(format);
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#include "CookedMesh.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr uint32_t COOKED_MAGIC = 0x4D535046; // "FPSM"
+    constexpr size_t BLOB_ALIGNMENT = 16;
+
+    /**
+     * @struct FileHeader
+     * @brief Nagłówek pliku; za nim następuje meshCount opisów MeshHeader.
+     */
+    struct FileHeader {
+        uint32_t magic;          /**< COOKED_MAGIC. */
+        uint32_t version;        /**< CookedMesh::VERSION. */
+        uint32_t importFlags;    /**< Flagi importu Assimp. */
+        uint32_t packedVertices; /**< 1 = PackedVertex, 0 = MeshVertex. */
+        uint32_t meshCount;      /**< Liczba siatek. */
+        uint32_t reserved;       /**< Wyrównanie. */
+        float boundsMin[3];      /**< Minimalny narożnik AABB modelu. */
+        float boundsMax[3];      /**< Maksymalny narożnik AABB modelu. */
+    };
+
+    /**
+     * @struct LodHeader
+     * @brief Poziom szczegółowości siatki.
+     */
+    struct LodHeader {
+        uint32_t indexCount;     /**< Liczba indeksów. */
+        float error;             /**< Błąd uproszczenia. */
+        uint64_t indexOffset;    /**< Przesunięcie w EBO siatki (w bajtach). */
+    };
+
+    /**
+     * @struct MeshHeader
+     * @brief Opis siatki; przesunięcia liczone są od początku pliku.
+     */
+    struct MeshHeader {
+        uint64_t vertexOffset;   /**< Początek zawartości VBO. */
+        uint64_t vertexBytes;    /**< Rozmiar VBO. */
+        uint64_t indexOffset;    /**< Początek zawartości EBO. */
+        uint64_t indexBytes;     /**< Rozmiar EBO. */
+        uint64_t textureOffset;  /**< Początek ścieżki tekstury. */
+        uint32_t textureLength;  /**< Długość ścieżki tekstury (0 = brak). */
+        uint32_t vertexCount;    /**< Liczba wierzchołków. */
+        uint32_t indexType;      /**< GL_UNSIGNED_SHORT lub GL_UNSIGNED_INT. */
+        uint32_t lodCount;       /**< Liczba poziomów szczegółowości (co najmniej 1). */
+        float quantizationOffset[3]; /**< VertexQuantization::offset. */
+        float quantizationScale[3];  /**< VertexQuantization::scale. */
+        LodHeader lods[MeshCache::MAX_LOD_LEVELS]; /**< Poziomy szczegółowości. */
+    };
+
+    size_t alignUp(size_t value) {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    bool inRange(uint64_t offset, uint64_t length, size_t fileSize) {
+        return offset <= fileSize && length <= fileSize - offset;
+    }
+}
+
+std::string CookedMesh::pathFor(const std::string& sourcePath) {
+    return std::filesystem::path(sourcePath).replace_extension(".mesh").generic_string();
+}
+
+bool CookedMesh::isFresh(const std::string& cookedPath, const std::string& sourcePath) {
+    std::error_code ec;
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+    if (ec) {
+        return false;
+    }
+    auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+    return ec || cookedTime >= sourceTime;
+}
+
+bool CookedMesh::write(const std::string& path, const CpuModel& model, unsigned int importFlags) {
+    std::vector<BakedMesh> baked(model.meshes.size());
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        MeshCache::bake(model.meshes[i], baked[i]);
+    }
+
+    FileHeader header{};
+    header.magic = COOKED_MAGIC;
+    header.version = VERSION;
+    header.importFlags = importFlags;
+    header.packedVertices = PACK_MESH_VERTICES ? 1 : 0;
+    header.meshCount = static_cast<uint32_t>(baked.size());
+    for (int axis = 0; axis < 3; ++axis) {
+        header.boundsMin[axis] = model.boundsMin[axis];
+        header.boundsMax[axis] = model.boundsMax[axis];
+    }
+
+    // Najpierw opisy siatek, potem dane - rozmieszczenie znane jest przed zapisem
+    std::vector<MeshHeader> meshHeaders(baked.size());
+    size_t offset = alignUp(sizeof(FileHeader) + meshHeaders.size() * sizeof(MeshHeader));
+    for (size_t i = 0; i < baked.size(); ++i) {
+        const BakedMesh& mesh = baked[i];
+        MeshHeader& meshHeader = meshHeaders[i];
+        meshHeader = MeshHeader{};
+        if (mesh.info.lods.empty() || mesh.info.lods.size() > MeshCache::MAX_LOD_LEVELS) {
+            std::cerr << "Cannot cook mesh with " << mesh.info.lods.size() << " LOD levels: " << path << std::endl;
+            return false;
+        }
+
+        meshHeader.vertexOffset = offset;
+        meshHeader.vertexBytes = mesh.vertexData.size();
+        offset = alignUp(offset + mesh.vertexData.size());
+        meshHeader.indexOffset = offset;
+        meshHeader.indexBytes = mesh.indexData.size();
+        offset = alignUp(offset + mesh.indexData.size());
+        meshHeader.textureOffset = offset;
+        meshHeader.textureLength = static_cast<uint32_t>(mesh.info.texturePath.size());
+        offset = alignUp(offset + mesh.info.texturePath.size());
+
+        meshHeader.vertexCount = static_cast<uint32_t>(mesh.info.vertexCount);
+        meshHeader.indexType = mesh.info.indexType;
+        meshHeader.lodCount = static_cast<uint32_t>(mesh.info.lods.size());
+        for (int axis = 0; axis < 3; ++axis) {
+            meshHeader.quantizationOffset[axis] = mesh.info.quantization.offset[axis];
+            meshHeader.quantizationScale[axis] = mesh.info.quantization.scale[axis];
+        }
+        for (size_t level = 0; level < mesh.info.lods.size(); ++level) {
+            const MeshLod& lod = mesh.info.lods[level];
+            meshHeader.lods[level] = { static_cast<uint32_t>(lod.indexCount), lod.error, lod.indexOffset };
+        }
+    }
+
+    std::vector<unsigned char> bytes(offset, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), meshHeaders.data(), meshHeaders.size() * sizeof(MeshHeader));
+    for (size_t i = 0; i < baked.size(); ++i) {
+        const MeshHeader& meshHeader = meshHeaders[i];
+        std::memcpy(bytes.data() + meshHeader.vertexOffset, baked[i].vertexData.data(), meshHeader.vertexBytes);
+        std::memcpy(bytes.data() + meshHeader.indexOffset, baked[i].indexData.data(), meshHeader.indexBytes);
+        std::memcpy(bytes.data() + meshHeader.textureOffset, baked[i].info.texturePath.data(), meshHeader.textureLength);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {
+            std::cerr << "Failed to write cooked mesh: " << temporary << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::cerr << "Failed to write cooked mesh: " << path << std::endl;
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+bool CookedMesh::read(const MappedFile& file, unsigned int importFlags, ModelBlob& out) {
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+
+    FileHeader header;
+    if (!data || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != COOKED_MAGIC || header.version != VERSION || header.importFlags != importFlags
+        || header.packedVertices != (PACK_MESH_VERTICES ? 1u : 0u)
+        || !inRange(sizeof(header), static_cast<uint64_t>(header.meshCount) * sizeof(MeshHeader), size)) {
+        return false;
+    }
+
+    out.meshes.clear();
+    out.meshes.reserve(header.meshCount);
+    out.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    out.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+
+    const size_t vertexSize = PACK_MESH_VERTICES ? sizeof(PackedVertex) : sizeof(MeshVertex);
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        MeshHeader meshHeader;
+        std::memcpy(&meshHeader, data + sizeof(header) + i * sizeof(MeshHeader), sizeof(meshHeader));
+
+        size_t indexSize = meshHeader.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        if (!inRange(meshHeader.vertexOffset, meshHeader.vertexBytes, size)
+            || !inRange(meshHeader.indexOffset, meshHeader.indexBytes, size)
+            || !inRange(meshHeader.textureOffset, meshHeader.textureLength, size)
+            || meshHeader.vertexBytes != static_cast<uint64_t>(meshHeader.vertexCount) * vertexSize
+            || (meshHeader.indexType != GL_UNSIGNED_SHORT && meshHeader.indexType != GL_UNSIGNED_INT)
+            || meshHeader.lodCount == 0 || meshHeader.lodCount > MeshCache::MAX_LOD_LEVELS) {
+            std::cerr << "Corrupted cooked mesh (mesh " << i << ")" << std::endl;
+            return false;
+        }
+
+        MeshBlob blob;
+        blob.vertexData = data + meshHeader.vertexOffset;
+        blob.vertexBytes = static_cast<size_t>(meshHeader.vertexBytes);
+        blob.indexData = data + meshHeader.indexOffset;
+        blob.indexBytes = static_cast<size_t>(meshHeader.indexBytes);
+        blob.vertexCount = static_cast<GLsizei>(meshHeader.vertexCount);
+        blob.indexType = meshHeader.indexType;
+        blob.quantization.offset = glm::vec3(meshHeader.quantizationOffset[0], meshHeader.quantizationOffset[1], meshHeader.quantizationOffset[2]);
+        blob.quantization.scale = glm::vec3(meshHeader.quantizationScale[0], meshHeader.quantizationScale[1], meshHeader.quantizationScale[2]);
+        blob.texturePath.assign(reinterpret_cast<const char*>(data + meshHeader.textureOffset), meshHeader.textureLength);
+        for (uint32_t level = 0; level < meshHeader.lodCount; ++level) {
+            const LodHeader& lod = meshHeader.lods[level];
+            if (!inRange(lod.indexOffset, static_cast<uint64_t>(lod.indexCount) * indexSize, blob.indexBytes)) {
+                std::cerr << "Corrupted cooked mesh (mesh " << i << ", LOD " << level << ")" << std::endl;
+                return false;
+            }
+            blob.lods.push_back({ static_cast<GLsizei>(lod.indexCount), static_cast<uintptr_t>(lod.indexOffset), lod.error });
+        }
+        out.meshes.push_back(std::move(blob));
+    }
+    return true;
+}
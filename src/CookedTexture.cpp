@@ -0,0 +1,172 @@
+#include "CookedTexture.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr uint32_t DDS_MAGIC = 0x20534444;     // "DDS "
+    constexpr uint32_t COOKED_MAGIC = 0x54535046;  // "FPST"
+    constexpr uint32_t FOURCC_DXT1 = 0x31545844;   // "DXT1"
+    constexpr uint32_t FOURCC_DXT5 = 0x35545844;   // "DXT5"
+
+    constexpr uint32_t DDSD_CAPS = 0x1;
+    constexpr uint32_t DDSD_HEIGHT = 0x2;
+    constexpr uint32_t DDSD_WIDTH = 0x4;
+    constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+    constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+    constexpr uint32_t DDPF_FOURCC = 0x4;
+    constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+    constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+    constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+    /**
+     * @struct DdsPixelFormat
+     * @brief DDS_PIXELFORMAT.
+     */
+    struct DdsPixelFormat {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t rgbBitCount;
+        uint32_t bitMasks[4];
+    };
+
+    /**
+     * @struct DdsHeader
+     * @brief DDS_HEADER poprzedzony sygnaturą pliku.
+     */
+    struct DdsHeader {
+        uint32_t magic;          /**< DDS_MAGIC. */
+        uint32_t size;           /**< 124. */
+        uint32_t flags;
+        uint32_t height;
+        uint32_t width;
+        uint32_t linearSize;     /**< Rozmiar pierwszego poziomu w bajtach. */
+        uint32_t depth;
+        uint32_t mipMapCount;
+        uint32_t reserved1[11];  /**< [0] = COOKED_MAGIC, [1] = CookedTexture::VERSION. */
+        DdsPixelFormat pixelFormat;
+        uint32_t caps;
+        uint32_t caps2;
+        uint32_t caps3;
+        uint32_t caps4;
+        uint32_t reserved2;
+    };
+    static_assert(sizeof(DdsHeader) == 128, "DDS header must be 128 bytes");
+}
+
+std::string CookedTexture::pathFor(const std::string& sourcePath) {
+    return std::filesystem::path(sourcePath).replace_extension(".dds").generic_string();
+}
+
+bool CookedTexture::isFresh(const std::string& cookedPath, const std::string& sourcePath) {
+    std::error_code ec;
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, ec);
+    if (ec) {
+        return false;
+    }
+    auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+    return ec || cookedTime >= sourceTime;
+}
+
+bool CookedTexture::write(const std::string& path, const MipChain& chain) {
+    BlockFormat format = formatFor(chain.channels);
+    const MipLevel& base = chain.levels[0];
+
+    DdsHeader header{};
+    header.magic = DDS_MAGIC;
+    header.size = sizeof(DdsHeader) - sizeof(uint32_t);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height = static_cast<uint32_t>(base.height);
+    header.width = static_cast<uint32_t>(base.width);
+    header.linearSize = static_cast<uint32_t>(BlockCompression::imageBytes(format, base.width, base.height));
+    header.mipMapCount = static_cast<uint32_t>(chain.levels.size());
+    header.reserved1[0] = COOKED_MAGIC;
+    header.reserved1[1] = VERSION;
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = format == BlockFormat::BC1 ? FOURCC_DXT1 : FOURCC_DXT5;
+    header.caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+    std::vector<uint8_t> bytes(sizeof(header));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t level = 0; level < chain.levels.size(); ++level) {
+        const MipLevel& mip = chain.levels[level];
+        BlockCompression::compress(chain.levelData(level), mip.width, mip.height, chain.channels, format, bytes);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {
+            std::cerr << "Failed to write cooked texture: " << temporary << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::cerr << "Failed to write cooked texture: " << path << std::endl;
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+bool CookedTexture::read(const MappedFile& file, CompressedTexture& out) {
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+
+    DdsHeader header;
+    if (!data || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != DDS_MAGIC || header.reserved1[0] != COOKED_MAGIC || header.reserved1[1] != VERSION
+        || !(header.pixelFormat.flags & DDPF_FOURCC) || header.width == 0 || header.height == 0
+        || header.mipMapCount == 0) {
+        return false;
+    }
+
+    BlockFormat format;
+    if (header.pixelFormat.fourCC == FOURCC_DXT1) {
+        format = BlockFormat::BC1;
+        out.format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+    else if (header.pixelFormat.fourCC == FOURCC_DXT5) {
+        format = BlockFormat::BC3;
+        out.format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+    else {
+        return false;
+    }
+
+    out.data = data + sizeof(header);
+    out.levels.clear();
+    size_t offset = 0;
+    size_t available = size - sizeof(header);
+    int width = static_cast<int>(header.width);
+    int height = static_cast<int>(header.height);
+    for (uint32_t level = 0; level < header.mipMapCount; ++level) {
+        MipLevel mip;
+        mip.width = width;
+        mip.height = height;
+        mip.offset = offset;
+        mip.size = BlockCompression::imageBytes(format, width, height);
+        if (mip.size > available - offset) {
+            std::cerr << "Corrupted cooked texture (level " << level << ")" << std::endl;
+            return false;
+        }
+        out.levels.push_back(mip);
+        offset += mip.size;
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return true;
+}
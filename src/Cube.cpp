@@ -79,33 +79,44 @@ void Cube::setupBuffers() {
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
+    RenderQueue::setupInstanceAttributes();
+
     glBindVertexArray(0);
 }
 
-void Cube::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    glUseProgram(shaderProgram);
-
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+void Cube::submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const {
+    DrawPacket packet;
+    packet.shader = &shader;
+    packet.vao = vao;
+    packet.indexCount = static_cast<GLsizei>(indices.size());
+    packet.model = model;
 
+    // Wszystkie ściany rysowane są jednym wywołaniem, więc obowiązuje ostatnia ustawiona tekstura
     for (int side = 0; side < 6; ++side) {
         if (textures[side] != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textures[side]);
-            glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
+            packet.texture = textures[side];
         }
     }
 
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    glm::vec3 center(0.0f);
+    for (size_t i = 0; i < vertices.size(); i += 8) {
+        center += glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]);
+    }
+    center /= static_cast<float>(vertices.size() / 8);
 
-    glUseProgram(0);
+    queue.submit(pass, packet, glm::vec3(model * glm::vec4(center, 1.0f)));
 }
 
 
 
+BoundingSphere Cube::getBoundingSphere() const {
+    if (boundsDirty) {
+        bounds = BoundingSphere::fromVertices(vertices.data(), vertices.size(), 8);
+        boundsDirty = false;
+    }
+    return bounds;
+}
+
 void Cube::setTextureForSide(int side, GLuint textureID) {
     if (side >= 0 && side < 6) {
         textures[side] = textureID;
@@ -121,6 +132,7 @@ void Cube::translate(const glm::vec3& direction) {
 
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    boundsDirty = true;
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -142,6 +154,7 @@ void Cube::rotate(float angle, const glm::vec3& axis) {
 
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    boundsDirty = true;
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -178,6 +191,7 @@ void Cube::scale(float sx, float sy) {
 
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    boundsDirty = true;
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
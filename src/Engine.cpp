@@ -2,6 +2,11 @@
 
 
 const unsigned int SHADOW_WIDTH = 2048, SHADOW_HEIGHT = 2048;
+// Czas na klatk, jaki wtek gwny powica na przesyanie wczytanych w tle zasobw
+const double ASSET_UPLOAD_BUDGET_MS = 2.0;
+// Bajty tekseli przesyane na klatk przez piercie PBO oraz jego pojemno
+const size_t TEXTURE_UPLOAD_BUDGET_BYTES = 4 * 1024 * 1024;
+const size_t TEXTURE_UPLOAD_RING_BYTES = 16 * 1024 * 1024;
 
 
 int Engine::windowWidth = 800;
@@ -14,7 +19,13 @@ Observer* observer = nullptr;
 std::vector<Cube*> cubes;
 std::vector<Wall*> walls;
 std::vector<ModelObject*> drawableObjects;
-Shader* mainShader;
+ShaderPermutations* mainShaders = nullptr;
+const Shader* mainShader = nullptr;
+const Shader* untexturedShader = nullptr;
+const Shader* overlayShader = nullptr;
+const Shader* overlayUntexturedShader = nullptr;
+bool shadowsEnabled = true;
+ShaderBatch* startupShaders = nullptr;
 Shader* depthShader;
 std::vector<Light> lights;
 HUDRenderer hud;
@@ -23,6 +34,42 @@ GLuint woodTexture = 0;
 Cube* lightCube = nullptr;
 HeldWeapon* currentWeapon = nullptr;
 
+UniformBuffer* frameDataBuffer = nullptr;
+UniformBuffer* lightDataBuffer = nullptr;
+FrameData frameData[2];
+LightData lightData;
+GLuint shadowFBO = 0;
+GLuint shadowMapArray = 0;
+GLuint staticShadowFBO = 0;
+GLuint staticShadowMapArray = 0;
+RenderQueue renderQueue;
+GLuint defaultTexture = 0;
+std::vector<ModelObject*> staticModels;
+StaticGeometry staticGeometry;
+bool useStaticGeometry = true;
+Frustum viewFrustum;
+CullingStats cullingStats;
+bool staticShadowsDirty = true;
+std::vector<PointLight> lamps;
+std::vector<TransientLight> muzzleFlashes;
+std::vector<PointLight> pointLights;
+LightClusters lightClusters;
+AssetLoader* assetLoader = nullptr;
+PixelUploadRing* textureUploadRing = nullptr;
+size_t staticModelsBuilt = 0;
+
+/**
+ * @brief Sprawdza, czy obiekt z dan macierz modelu jest w kadrze, i aktualizuje liczniki odrzucania.
+ */
+static bool isInView(const DrawableObject& object, const glm::mat4& model) {
+    if (viewFrustum.isVisible(object.getBoundingSphere().transformed(model))) {
+        cullingStats.visible++;
+        return true;
+    }
+    cullingStats.culled++;
+    return false;
+}
+
 
 std::set<char> currentlyHeldKeys;
 float lastFrameTime = 0.0f;
@@ -55,6 +102,7 @@ Engine::Engine(int argc, char** argv, int width, int height, const char* title)
     hud.init();
 
     setup2();
+    buildStaticGeometry();
 
     
 
@@ -76,9 +124,110 @@ void Engine::initSettings() {
     glClearColor(0.15f, 0.15f, 0.15f, 1.0f);
     glViewport(0, 0, windowWidth, windowHeight);
     debugmode = 0;
-    mainShader = new Shader("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
-    depthShader = new Shader("shaders/depth_vertex_shader.glsl", "shaders/depth_fragment_shader.glsl");
+    // Modele i tekstury wczytywane s w tle - pierwsza klatka nie czeka na dysk
+    assetLoader = new AssetLoader();
+    MeshCache::setLoader(assetLoader);
+    BitmapHandler::setLoader(assetLoader);
+    // Zdekodowane tekstury trafiaj na GPU przez PBO, po kilka MB na klatk
+    textureUploadRing = new PixelUploadRing(TEXTURE_UPLOAD_RING_BYTES);
+    BitmapHandler::setUploadRing(textureUploadRing);
+    // Programy startowe kompiluj si w tle, rwnolegle z wczytywaniem tekstur i modeli
+    startupShaders = new ShaderBatch();
+    mainShaders = new ShaderPermutations("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
+    depthShader = startupShaders->add("shaders/depth_vertex_shader.glsl", "shaders/depth_fragment_shader.glsl", "shaders/depth_geometry_shader.glsl");
+    // Slot 0: kamera sceny, slot 1: kamera trzymanej broni
+    frameDataBuffer = new UniformBuffer(FRAME_DATA_BINDING, sizeof(FrameData), 2);
+    lightDataBuffer = new UniformBuffer(LIGHT_DATA_BINDING, sizeof(LightData));
     initializeLights();
+    for (int clustered = 0; clustered <= 1; ++clustered) {
+        for (int textured = 0; textured <= 1; ++textured) {
+            mainShaders->request(mainShaderDefines(clustered != 0, textured != 0), *startupShaders);
+        }
+    }
+
+    // Biaa tekstura dla siatek bez wasnego materiau
+    defaultTexture = BitmapHandler::createBitmap(1, 1, 255, 255, 255);
+    renderQueue.setDefaultTexture(defaultTexture);
+}
+
+ShaderDefines Engine::mainShaderDefines(bool clustered, bool textured) {
+    int shadowLayers = shadowsEnabled ? (int)lights.size() : 0;
+    return {
+        { "SHADOW_LIGHTS", shadowLayers },
+        { "DEBUG_VIEW", debugmode <= shadowLayers ? debugmode : 0 },
+        { "CLUSTERED", clustered ? 1 : 0 },
+        { "TEXTURED", textured ? 1 : 0 },
+    };
+}
+
+void Engine::selectShaderPermutations() {
+    mainShader = &mainShaders->get(mainShaderDefines(true, true));
+    untexturedShader = &mainShaders->get(mainShaderDefines(true, false));
+    // Bro rysowana wasn kamer nie korzysta z siatki klastrw
+    overlayShader = &mainShaders->get(mainShaderDefines(false, true));
+    overlayUntexturedShader = &mainShaders->get(mainShaderDefines(false, false));
+}
+
+void Engine::buildStaticGeometry() {
+    staticGeometry.clear();
+    staticGeometry.setDefaultTexture(defaultTexture);
+    for (Wall* wall : walls) {
+        staticGeometry.addWall(*wall);
+    }
+    staticModelsBuilt = 0;
+    for (ModelObject* model : staticModels) {
+        if (model->isLoaded()) {
+            staticGeometry.addModel(*model);
+            ++staticModelsBuilt;
+        }
+    }
+    staticGeometry.build();
+    staticShadowsDirty = true;
+
+    std::cout << "Static geometry: " << staticGeometry.getDrawCount() << " draws in "
+        << staticGeometry.getGroupCount() << " multi-draw calls per pass" << std::endl;
+}
+
+void Engine::createShadowTarget(GLuint& fbo, GLuint& texture, GLsizei layers) {
+    glGenFramebuffers(1, &fbo);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    // Format z rozmiarem, bo glCopyImageSubData wymaga zgodnych formatw obu tablic
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_WIDTH, SHADOW_HEIGHT, layers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    // Porwnanie gbokoci w sprzcie (sampler2DArrayShadow), z filtrowaniem 2x2
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+    float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Doczenie caej tablicy - geometry shader wybiera warstw przez gl_Layer
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Engine::updateStaticShadows() {
+    if (!staticShadowsDirty) {
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, staticShadowFBO);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    if (useStaticGeometry) {
+        staticGeometry.draw(RenderPass::ShadowStatic, *depthShader);
+    }
+    renderQueue.execute(RenderPass::ShadowStatic);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    staticShadowsDirty = false;
 }
 
 void Engine::initializeLights() {
@@ -89,33 +238,21 @@ void Engine::initializeLights() {
     glm::vec3(1.0f, 10.0f, 10.0f)
     };
 
-    for (int i = 0; i < lightPositions->length(); i++) {
+    for (int i = 0; i < lightPositions->length() && i < MAX_SHADOW_LIGHTS; i++) {
         Light light;
         light.position = lightPositions[i];
         light.color = glm::vec3(3.0f, 3.0f, 3.0f);
-
-        glGenFramebuffers(1, &light.shadowFBO);
-        glGenTextures(1, &light.shadowMap);
-        glBindTexture(GL_TEXTURE_2D, light.shadowMap);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-
-        float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, light.shadowFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, light.shadowMap, 0);
-        glDrawBuffer(GL_NONE);
-        glReadBuffer(GL_NONE);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        light.range = 60.0f;
+        light.lightSpaceMatrix = glm::mat4(1.0f);
 
         lights.push_back(light);
     }
+
+    createShadowTarget(shadowFBO, shadowMapArray, (GLsizei)lights.size());
+    createShadowTarget(staticShadowFBO, staticShadowMapArray, (GLsizei)lights.size());
     float color[] = { 0.2,0.8,0.8 };
-    GLuint texture = BitmapHandler::createBitmap(1024, 1024, 255*color[0], 255 * color[1], 255 * color[2]);
+    // Jednolity kolor nie potrzebuje wicej ni jednego teksela
+    GLuint texture = BitmapHandler::createBitmap(1, 1, 255*color[0], 255 * color[1], 255 * color[2]);
     lightCube = new Cube(0.5, 0.0, 0.0, 0.0, texture);
 
 }
@@ -124,105 +261,153 @@ void Engine::initializeLights() {
 void Engine::displayCallback() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
+    assetLoader->pump(ASSET_UPLOAD_BUDGET_MS);
+    BitmapHandler::streamUploads(TEXTURE_UPLOAD_BUDGET_BYTES);
 
-    glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-    for (size_t i = 0; i < lights.size(); i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, lights[i].shadowFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
+    // Dopki programy startowe si kompiluj, okno pozostaje responsywne zamiast blokowa ptl
+    if (startupShaders) {
+        if (!startupShaders->poll()) {
+            glutSwapBuffers();
+            return;
+        }
+        delete startupShaders;
+        startupShaders = nullptr;
+    }
 
-        depthShader->use();
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
 
-        glm::mat4 lightProjection = glm::ortho(-30.0f, 30.0f, -30.0f, 30.0f, 1.0f, 100.0f);
+    // Nieruchome modele doczaj do areny, gdy tylko ich siatki trafi na GPU
+    size_t staticModelsLoaded = std::count_if(staticModels.begin(), staticModels.end(),
+        [](const ModelObject* model) { return model->isLoaded(); });
+    if (staticModelsLoaded != staticModelsBuilt) {
+        buildStaticGeometry();
+    }
 
+    glm::mat4 lightProjection = glm::ortho(-30.0f, 30.0f, -30.0f, 30.0f, 1.0f, 100.0f);
+    lightData.numLights = (int)lights.size();
+    for (size_t i = 0; i < lights.size(); i++) {
         glm::mat4 lightView = glm::lookAt(
             lights[i].position, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        lights[i].lightSpaceMatrix = lightProjection * lightView;
-
-        glUniformMatrix4fv(glGetUniformLocation(depthShader->getProgramID(), "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(lights[i].lightSpaceMatrix));
-        glDisable(GL_CULL_FACE);
-        for (Wall* wall : walls) {
-            glm::mat4 model = glm::mat4(1.0f);
-            wall->draw(depthShader->getProgramID(), model, glm::mat4(1.0f), glm::mat4(1.0f));
-        }
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-
-        for (Cube* cube : cubes) {
-            glm::mat4 model = glm::mat4(1.0f);
-            cube->draw(depthShader->getProgramID(), model, glm::mat4(1.0f), glm::mat4(1.0f));
-        }
-
-        for (ModelObject* model : drawableObjects) {
-            glm::mat4 modelMatrix = model->getModelMatrix();
-            model->draw(depthShader->getProgramID(), modelMatrix, glm::mat4(1.0f), glm::mat4(1.0f));
+        glm::mat4 lightSpaceMatrix = lightProjection * lightView;
+        // Poruszone wiato uniewania statyczn warstw cieni
+        if (lightSpaceMatrix != lights[i].lightSpaceMatrix) {
+            lights[i].lightSpaceMatrix = lightSpaceMatrix;
+            staticShadowsDirty = true;
         }
 
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        lightData.lights[i].position = glm::vec4(lights[i].position, 1.0f);
+        lightData.lights[i].color = glm::vec4(lights[i].color, 1.0f);
+        lightData.lights[i].lightSpaceMatrix = lights[i].lightSpaceMatrix;
     }
-
-    glViewport(0, 0, windowWidth, windowHeight);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    mainShader->use();
-    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "debugMode"), debugmode);
-    glUniform1i(glGetUniformLocation(mainShader->getProgramID(), "numLights"), lights.size());
+    lightDataBuffer->uploadPartial(&lightData, offsetof(LightData, lights) + sizeof(GpuLight) * lights.size());
 
     glm::mat4 view = observer->getViewMatrix();
     glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
 
-    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-    for (size_t i = 0; i < lights.size(); ++i) {
-        std::string lightPosUniform = "lights[" + std::to_string(i) + "].position";
-        std::string lightColorUniform = "lights[" + std::to_string(i) + "].color";
-        std::string lightSpaceMatrixUniform = "lightSpaceMatrix[" + std::to_string(i) + "]";
-        std::string shadowMapUniform = "lights[" + std::to_string(i) + "].shadowMap";
-
-        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), lightPosUniform.c_str()), 1, glm::value_ptr(lights[i].position));
-        glUniform3fv(glGetUniformLocation(mainShader->getProgramID(), lightColorUniform.c_str()), 1, glm::value_ptr(lights[i].color));
-        glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), lightSpaceMatrixUniform.c_str()), 1, GL_FALSE, glm::value_ptr(lights[i].lightSpaceMatrix));
-       
-        glActiveTexture(GL_TEXTURE2 + i);
-        glBindTexture(GL_TEXTURE_2D, lights[i].shadowMap);
-        glUniform1i(glGetUniformLocation(mainShader->getProgramID(), shadowMapUniform.c_str()),2+ i);
+    // wiata z cieniem zajmuj pierwsze indeksy, po nich lampy i byski wystrzaw
+    pointLights.clear();
+    for (size_t i = 0; i < lights.size(); i++) {
+        pointLights.push_back({ lights[i].position, lights[i].range, lights[i].color, (int)i });
     }
-    glDisable(GL_CULL_FACE);
-    for (Wall* wall : walls) {
-        wall->draw(mainShader->getProgramID(), glm::mat4(1.0f), view, projection);
+    pointLights.insert(pointLights.end(), lamps.begin(), lamps.end());
+    for (const TransientLight& flash : muzzleFlashes) {
+        pointLights.push_back(flash.light);
+    }
+    lightClusters.update(view, projection, 0.1f, 100.0f, windowWidth, windowHeight, pointLights);
+
+    frameData[0] = { view, projection, observer->getPosition(), 0, lightClusters.getGrid(), lightClusters.getParams() };
+    // bro zawsze patrzy wprost
+    frameData[1] = { glm::mat4(1.0f), glm::perspective(glm::radians(60.0f),
+        (float)windowWidth / (float)windowHeight, 0.1f, 100.0f), glm::vec3(0.0f), 0 };
+    // Bro nie ley w siatce klastrw kamery sceny - jej wariant cieniuje wszystkie wiata
+    frameData[1].clusterGrid.w = (unsigned int)pointLights.size();
+    frameDataBuffer->upload(frameData, 2);
+    frameDataBuffer->bindSlot(0);
+
+    // Odrzucanie dotyczy tylko przebiegu gwnego - obiekty poza kadrem nadal rzucaj cienie
+    viewFrustum.update(projection * view);
+    cullingStats = CullingStats();
+    if (useStaticGeometry) {
+        staticGeometry.cull(viewFrustum, cullingStats);
     }
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
 
+    selectShaderPermutations();
+    renderQueue.clear();
+    renderQueue.setUntexturedVariant(*mainShader, *untexturedShader);
+    renderQueue.setUntexturedVariant(*overlayShader, *overlayUntexturedShader);
+    renderQueue.setViewPoint(observer->getPosition(), 100.0f);
+    renderQueue.setLodProjection(windowHeight / (2.0f * std::tan(glm::radians(45.0f) * 0.5f)));
+    if (!useStaticGeometry) {
+        for (Wall* wall : walls) {
+            if (staticShadowsDirty) {
+                wall->submit(renderQueue, RenderPass::ShadowStatic, *depthShader, glm::mat4(1.0f));
+            }
+            if (isInView(*wall, glm::mat4(1.0f))) {
+                wall->submit(renderQueue, RenderPass::Main, *mainShader, glm::mat4(1.0f));
+            }
+        }
+        for (ModelObject* model : staticModels) {
+            glm::mat4 modelMatrix = model->getModelMatrix();
+            if (staticShadowsDirty) {
+                model->submit(renderQueue, RenderPass::ShadowStatic, *depthShader, modelMatrix);
+            }
+            if (isInView(*model, modelMatrix)) {
+                model->submit(renderQueue, RenderPass::Main, *mainShader, modelMatrix);
+            }
+        }
+    }
     for (Cube* cube : cubes) {
-        cube->draw(mainShader->getProgramID(), glm::mat4(1.0f), view, projection);
+        cube->submit(renderQueue, RenderPass::Shadow, *depthShader, glm::mat4(1.0f));
+        if (isInView(*cube, glm::mat4(1.0f))) {
+            cube->submit(renderQueue, RenderPass::Main, *mainShader, glm::mat4(1.0f));
+        }
     }
     for (ModelObject* model : drawableObjects) {
-            glm::mat4 modelMatrix = model->getModelMatrix();
-            model->draw(mainShader->getProgramID(), modelMatrix, view, projection);
-            //std::cout << "Drawing model" << std::endl;
+        glm::mat4 modelMatrix = model->getModelMatrix();
+        model->submit(renderQueue, RenderPass::Shadow, *depthShader, modelMatrix);
+        if (isInView(*model, modelMatrix)) {
+            model->submit(renderQueue, RenderPass::Main, *mainShader, modelMatrix);
+        }
     }
-    
-
     for (size_t i = 0; i < lights.size(); i++) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, lights[i].position);
-        glUniformMatrix4fv(glGetUniformLocation(mainShader->getProgramID(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-        lightCube->draw(mainShader->getProgramID(), model, view, projection);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), lights[i].position);
+        if (isInView(*lightCube, model)) {
+            lightCube->submit(renderQueue, RenderPass::Main, *mainShader, model);
+        }
     }
-
     if (currentWeapon) {
-        glm::mat4 model = currentWeapon->getModelMatrix();
-        glm::mat4 weaponView = glm::mat4(1.0f); // bro zawsze patrzy wprost
-        glm::mat4 weaponProjection = glm::perspective(glm::radians(60.0f),
-            (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
+        currentWeapon->submit(renderQueue, RenderPass::Overlay, *overlayShader, currentWeapon->getModelMatrix());
+    }
+    renderQueue.sort();
+
+    if (shadowsEnabled) {
+        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+        updateStaticShadows();
+        // Warstwy statyczne wszystkich wiate kopiowane s jednym wywoaniem na GPU,
+        // a obiekty dynamiczne rasteryzowane w jednym przejciu do wszystkich warstw
+        glCopyImageSubData(staticShadowMapArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+            shadowMapArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+            SHADOW_WIDTH, SHADOW_HEIGHT, (GLsizei)lights.size());
+        glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
+        renderQueue.execute(RenderPass::Shadow);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    glViewport(0, 0, windowWidth, windowHeight);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        currentWeapon->draw(mainShader->getProgramID(), model, weaponView, weaponProjection);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMapArray);
+    if (useStaticGeometry) {
+        staticGeometry.draw(RenderPass::Main, *mainShader, untexturedShader);
+    }
+    renderQueue.execute(RenderPass::Main);
+
+    if (currentWeapon) {
+        frameDataBuffer->bindSlot(1);
+        renderQueue.execute(RenderPass::Overlay);
+        frameDataBuffer->bindSlot(0);
     }
 
     hud.drawCrosshair(windowWidth, windowHeight);
@@ -273,6 +458,7 @@ void Engine::keyboardCallback(unsigned char key, int x, int y) {
         }
         glm::vec3 rayOrigin = observer->getPosition();
         glm::vec3 rayDir = glm::normalize(observer->getTarget() - rayOrigin);
+        muzzleFlashes.push_back({ { rayOrigin + rayDir, 5.0f, glm::vec3(4.0f, 2.6f, 1.2f), -1 }, 0.06f });
 
         for (auto it = drawableObjects.begin(); it != drawableObjects.end(); ) {//bez it++
             if (auto* target = dynamic_cast<TargetObject*>(*it)) {
@@ -335,6 +521,22 @@ void Engine::keyboardCallback(unsigned char key, int x, int y) {
     case 'h':
         hud.setShowCrosshair();
         break;
+    case 'c':
+        std::cout << "Frustum culling: " << cullingStats.visible << " visible, "
+            << cullingStats.culled << " culled" << std::endl;
+        std::cout << "Light clusters: " << pointLights.size() << " lights, "
+            << lightClusters.getAssignmentCount() << " cluster assignments" << std::endl;
+        break;
+    case 'v':
+        // Wariant bez cieni pomija te przebiegi map cieni; statyczna warstwa jest odwieana po wczeniu
+        shadowsEnabled = !shadowsEnabled;
+        std::cout << "Shadows: " << (shadowsEnabled ? "on" : "off") << std::endl;
+        break;
+    case 'n':
+        useStaticGeometry = !useStaticGeometry;
+        staticShadowsDirty = true;
+        std::cout << "Static geometry multi-draw: " << (useStaticGeometry ? "on" : "off") << std::endl;
+        break;
 
     default:
         break;
@@ -388,11 +590,16 @@ void Engine::timerCallback(int value) {
     float deltaTime = currentTime - lastFrameTime;
     lastFrameTime = currentTime;
 
-    observer->applyMovementInput(currentlyHeldKeys, deltaTime, walls);
-    observer->updatePhysics(deltaTime, walls);
+    observer->applyMovementInput(currentlyHeldKeys, deltaTime, staticGeometry.getCollisionBoxes());
+    observer->updatePhysics(deltaTime, staticGeometry.getCollisionBoxes());
 
     currentWeapon->update(deltaTime);
 
+    for (auto it = muzzleFlashes.begin(); it != muzzleFlashes.end(); ) {
+        it->timeLeft -= deltaTime;
+        it = it->timeLeft <= 0.0f ? muzzleFlashes.erase(it) : it + 1;
+    }
+
     glutPostRedisplay();
     glutTimerFunc(1000 / 60, timerCallback, value); // 60 FPS
 }
@@ -493,20 +700,20 @@ void Engine::setup2()
         ModelObject* table = new ModelObject("models/table.obj");
         table->setPosition(glm::vec3(i * 2.5f, 0.0f, -1.5f));
         table->setScale(glm::vec3(0.01f));
-        drawableObjects.push_back(table);
+        staticModels.push_back(table);
     }
 
     ModelObject* ak = new ModelObject("models/AK-47.obj");
     ak->setPosition(glm::vec3(-6.0f, 1.0f, -1.0f));
     ak->setScale(glm::vec3(0.5f));
     ak->rotate(-90.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-    drawableObjects.push_back(ak);
+    staticModels.push_back(ak);
 
     ModelObject* sniper = new ModelObject("models/SniperRifle.obj");
     sniper->setPosition(glm::vec3(-6.0f, 2.0f, -1.0f));
     sniper->setScale(glm::vec3(0.5f));
     sniper->rotate(90.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-    drawableObjects.push_back(sniper);
+    staticModels.push_back(sniper);
 
     for (int i = 0; i < 5; ++i) {
         TargetObject* target = new TargetObject("models/Human.obj");
@@ -517,6 +724,13 @@ void Engine::setup2()
         drawableObjects.push_back(target);
     }
 
+    // Lampy nad stanowiskami strzeleckimi - bez cieni, o krtkim zasigu
+    for (int i = 0; i < 8; ++i) {
+        float z = -8.0f + i * 4.0f;
+        lamps.push_back({ glm::vec3(-6.0f, 3.5f, z), 6.0f, glm::vec3(1.2f, 1.0f, 0.7f), -1 });
+        lamps.push_back({ glm::vec3(6.0f, 3.5f, z), 6.0f, glm::vec3(1.2f, 1.0f, 0.7f), -1 });
+    }
+
     currentWeapon = new HeldWeapon("models/P90.obj");
     currentWeapon->setScale(glm::vec3(0.5f));
     //currentWeapon->rotate(180.0f, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -536,6 +750,13 @@ void Engine::keyboard(unsigned char key, int x, int y)
 
 
 Engine::~Engine() {
+    // Zakoczenia zada w toku odwouj si do pamici podrcznych zasobw
+    MeshCache::setLoader(nullptr);
+    BitmapHandler::setLoader(nullptr);
+    BitmapHandler::setUploadRing(nullptr);
+    delete assetLoader;
+    delete textureUploadRing;
+
     delete observer;
     for (Cube* cube : cubes) {
         delete cube;
@@ -544,15 +765,20 @@ Engine::~Engine() {
     for (Wall* wall : walls) {
         delete wall;
     }
-    BitmapHandler::deleteBitmap(wallTexture);
-    BitmapHandler::deleteBitmap(wallTexture);
-
-    for (Light light : lights) {
-        BitmapHandler::deleteBitmap(light.shadowFBO);
-    }
+    BitmapHandler::releaseBitmap(wallTexture);
+    BitmapHandler::releaseBitmap(woodTexture);
+    BitmapHandler::deleteBitmap(defaultTexture);
+
+    glDeleteFramebuffers(1, &shadowFBO);
+    glDeleteFramebuffers(1, &staticShadowFBO);
+    glDeleteTextures(1, &shadowMapArray);
+    glDeleteTextures(1, &staticShadowMapArray);
     
 
-    delete mainShader;
+    delete startupShaders;
+    delete mainShaders;
     delete depthShader;
+    delete frameDataBuffer;
+    delete lightDataBuffer;
 
 }
@@ -0,0 +1,106 @@
+#include "Frustum.h"
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4& model) const {
+    if (!isValid()) {
+        return *this;
+    }
+    float scaleX = glm::length(glm::vec3(model[0]));
+    float scaleY = glm::length(glm::vec3(model[1]));
+    float scaleZ = glm::length(glm::vec3(model[2]));
+
+    BoundingSphere result;
+    result.center = glm::vec3(model * glm::vec4(center, 1.0f));
+    result.radius = radius * std::max(scaleX, std::max(scaleY, scaleZ));
+    return result;
+}
+
+BoundingSphere BoundingSphere::fromBounds(const glm::vec3& min, const glm::vec3& max) {
+    BoundingSphere result;
+    result.center = (min + max) * 0.5f;
+    result.radius = glm::length(max - min) * 0.5f;
+    return result;
+}
+
+BoundingSphere BoundingSphere::fromVertices(const float* data, size_t floatCount, size_t stride) {
+    if (floatCount < 3 || stride < 3) {
+        return BoundingSphere();
+    }
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    for (size_t i = 0; i + 3 <= floatCount; i += stride) {
+        glm::vec3 p(data[i], data[i + 1], data[i + 2]);
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    return fromBounds(min, max);
+}
+
+void Frustum::update(const glm::mat4& viewProjection) {
+    // Metoda Gribba-Hartmanna: płaszczyzny to sumy/różnice wierszy macierzy
+    glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    glm::vec4 planes[8] = {
+        row3 + row0, row3 - row0,  // lewa, prawa
+        row3 + row1, row3 - row1,  // dolna, górna
+        row3 + row2, row3 - row2,  // bliska, daleka
+    };
+
+    for (int i = 0; i < 6; ++i) {
+        float length = glm::length(glm::vec3(planes[i]));
+        if (length > 0.0f) {
+            planes[i] /= length;
+        }
+    }
+    planes[6] = planes[0];
+    planes[7] = planes[1];
+
+    for (int i = 0; i < 8; ++i) {
+        planeX[i] = planes[i].x;
+        planeY[i] = planes[i].y;
+        planeZ[i] = planes[i].z;
+        planeW[i] = planes[i].w;
+    }
+}
+
+bool Frustum::isVisible(const BoundingSphere& sphere) const {
+    if (!sphere.isValid()) {
+        return true;
+    }
+
+#ifdef FRUSTUM_USE_SSE
+    const __m128 cx = _mm_set1_ps(sphere.center.x);
+    const __m128 cy = _mm_set1_ps(sphere.center.y);
+    const __m128 cz = _mm_set1_ps(sphere.center.z);
+    const __m128 negRadius = _mm_set1_ps(-sphere.radius);
+
+    for (int i = 0; i < 8; i += 4) {
+        __m128 d = _mm_mul_ps(_mm_load_ps(planeX + i), cx);
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_load_ps(planeY + i), cy));
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_load_ps(planeZ + i), cz));
+        d = _mm_add_ps(d, _mm_load_ps(planeW + i));
+        if (_mm_movemask_ps(_mm_cmplt_ps(d, negRadius)) != 0) {
+            return false;
+        }
+    }
+    return true;
+#else
+    for (int i = 0; i < 6; ++i) {
+        float d = planeX[i] * sphere.center.x + planeY[i] * sphere.center.y
+            + planeZ[i] * sphere.center.z + planeW[i];
+        if (d < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
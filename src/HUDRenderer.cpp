@@ -6,7 +6,7 @@ HUDRenderer::HUDRenderer() {}
 
 HUDRenderer::~HUDRenderer() {
     if (crosshairTexture) {
-        BitmapHandler::deleteBitmap(crosshairTexture);
+        BitmapHandler::releaseBitmap(crosshairTexture);
     }
     if (quadVBO) glDeleteBuffers(1, &quadVBO);
     if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
@@ -15,6 +15,11 @@ HUDRenderer::~HUDRenderer() {
 
 void HUDRenderer::init() {
     hudShader = new Shader("shaders/vertex_hud_shader.glsl", "shaders/fragment_hud_shader.glsl");
+    colorUniform = hudShader->getUniform("crosshairColor");
+    lineWidthUniform = hudShader->getUniform("lineWidth");
+    gapSizeUniform = hudShader->getUniform("gapSize");
+    lengthUniform = hudShader->getUniform("crosshairLength");
+    resolutionUniform = hudShader->getUniform("resolution");
     //loadCrosshairTexture("textures/crosshair.png");
     setupQuad();
 }
@@ -88,16 +93,16 @@ void HUDRenderer::drawCrosshair(int windowWidth, int windowHeight) {
     hudShader->use();
     glBindVertexArray(quadVAO);
 
-    glUniform3fv(glGetUniformLocation(hudShader->getProgramID(), "crosshairColor"), 1, glm::value_ptr(crosshairColor));
+    hudShader->setVec3(colorUniform, crosshairColor);
     float lineWidth = 1.5f;
     float gapSize = 4.0f;
 
-    glUniform1f(glGetUniformLocation(hudShader->getProgramID(), "lineWidth"), lineWidth);
-    glUniform1f(glGetUniformLocation(hudShader->getProgramID(), "gapSize"), gapSize);
-    glUniform1f(glGetUniformLocation(hudShader->getProgramID(), "crosshairLength"), crosshairSize);
-    glUniform2f(glGetUniformLocation(hudShader->getProgramID(), "resolution"),
+    hudShader->setFloat(lineWidthUniform, lineWidth);
+    hudShader->setFloat(gapSizeUniform, gapSize);
+    hudShader->setFloat(lengthUniform, crosshairSize);
+    hudShader->setVec2(resolutionUniform, glm::vec2(
         static_cast<float>(windowWidth),
-        static_cast<float>(windowHeight));
+        static_cast<float>(windowHeight)));
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
@@ -0,0 +1,181 @@
+#include "LightClusters.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CLUSTERS_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t TILES_PER_SLICE = LightClusters::TILES_X * LightClusters::TILES_Y;
+    static_assert(TILES_PER_SLICE % 4 == 0, "Clusters are tested in groups of four");
+}
+
+LightClusters::~LightClusters() {
+    if (lightBuffer) glDeleteBuffers(1, &lightBuffer);
+    if (rangeBuffer) glDeleteBuffers(1, &rangeBuffer);
+    if (indexBuffer) glDeleteBuffers(1, &indexBuffer);
+}
+
+glm::uvec4 LightClusters::getGrid() const {
+    glm::uvec4 grid;
+    grid.x = TILES_X;
+    grid.y = TILES_Y;
+    grid.z = SLICES;
+    grid.w = lightCount;
+    return grid;
+}
+
+int LightClusters::sliceFor(float depth) const {
+    if (depth <= nearPlane) {
+        return 0;
+    }
+    int slice = static_cast<int>(std::floor(std::log(depth) * params.z - params.w));
+    return std::min(std::max(slice, 0), static_cast<int>(SLICES) - 1);
+}
+
+void LightClusters::buildClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane) {
+    boundsProjection = projection;
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+
+    minX.resize(CLUSTER_COUNT); minY.resize(CLUSTER_COUNT); minZ.resize(CLUSTER_COUNT);
+    maxX.resize(CLUSTER_COUNT); maxY.resize(CLUSTER_COUNT); maxZ.resize(CLUSTER_COUNT);
+
+    // Kierunki promieni przez narożniki kafelków, przeskalowane tak, by z = -1
+    glm::mat4 inverseProjection = glm::inverse(projection);
+    std::vector<glm::vec3> corners((TILES_X + 1) * (TILES_Y + 1));
+    for (uint32_t y = 0; y <= TILES_Y; ++y) {
+        for (uint32_t x = 0; x <= TILES_X; ++x) {
+            glm::vec4 ndc(2.0f * x / TILES_X - 1.0f, 2.0f * y / TILES_Y - 1.0f, -1.0f, 1.0f);
+            glm::vec4 point = inverseProjection * ndc;
+            glm::vec3 ray = glm::vec3(point) / point.w;
+            corners[y * (TILES_X + 1) + x] = ray / -ray.z;
+        }
+    }
+
+    for (uint32_t slice = 0; slice < SLICES; ++slice) {
+        float sliceNear = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(slice) / SLICES);
+        float sliceFar = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(slice + 1) / SLICES);
+        for (uint32_t y = 0; y < TILES_Y; ++y) {
+            for (uint32_t x = 0; x < TILES_X; ++x) {
+                glm::vec3 low(FLT_MAX);
+                glm::vec3 high(-FLT_MAX);
+                for (uint32_t corner = 0; corner < 4; ++corner) {
+                    const glm::vec3& ray = corners[(y + corner / 2) * (TILES_X + 1) + x + corner % 2];
+                    low = glm::min(low, glm::min(ray * sliceNear, ray * sliceFar));
+                    high = glm::max(high, glm::max(ray * sliceNear, ray * sliceFar));
+                }
+                uint32_t index = slice * TILES_PER_SLICE + y * TILES_X + x;
+                minX[index] = low.x; minY[index] = low.y; minZ[index] = low.z;
+                maxX[index] = high.x; maxY[index] = high.y; maxZ[index] = high.z;
+            }
+        }
+    }
+
+    float logRatio = std::log(farPlane / nearPlane);
+    params.z = SLICES / logRatio;
+    params.w = SLICES * std::log(nearPlane) / logRatio;
+}
+
+void LightClusters::update(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane,
+    int viewportWidth, int viewportHeight, const std::vector<PointLight>& lights) {
+    if (projection != boundsProjection || nearPlane != this->nearPlane || farPlane != this->farPlane) {
+        buildClusterBounds(projection, nearPlane, farPlane);
+    }
+    params.x = static_cast<float>(viewportWidth) / TILES_X;
+    params.y = static_cast<float>(viewportHeight) / TILES_Y;
+    lightCount = static_cast<uint32_t>(lights.size());
+
+    hits.clear();
+    for (uint32_t lightIndex = 0; lightIndex < lightCount; ++lightIndex) {
+        const PointLight& light = lights[lightIndex];
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float depth = -center.z;
+        if (light.range <= 0.0f || depth + light.range < nearPlane || depth - light.range > farPlane) {
+            continue;
+        }
+
+        // Zasięg światła wyznacza przedział plastrów - pozostałych nie trzeba testować
+        int firstSlice = sliceFor(depth - light.range);
+        int lastSlice = sliceFor(depth + light.range);
+        float radiusSquared = light.range * light.range;
+
+#ifdef CLUSTERS_USE_SSE
+        const __m128 cx = _mm_set1_ps(center.x);
+        const __m128 cy = _mm_set1_ps(center.y);
+        const __m128 cz = _mm_set1_ps(center.z);
+        const __m128 r2 = _mm_set1_ps(radiusSquared);
+        const __m128 zero = _mm_setzero_ps();
+#endif
+        for (int slice = firstSlice; slice <= lastSlice; ++slice) {
+            uint32_t begin = slice * TILES_PER_SLICE;
+            for (uint32_t i = begin; i < begin + TILES_PER_SLICE; i += 4) {
+#ifdef CLUSTERS_USE_SSE
+                // Kwadrat odległości środka sfery od prostopadłościanu, cztery klastry naraz
+                __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minX[i]), cx), _mm_sub_ps(cx, _mm_loadu_ps(&maxX[i]))), zero);
+                __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minY[i]), cy), _mm_sub_ps(cy, _mm_loadu_ps(&maxY[i]))), zero);
+                __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minZ[i]), cz), _mm_sub_ps(cz, _mm_loadu_ps(&maxZ[i]))), zero);
+                __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    if (mask & (1 << lane)) {
+                        hits.push_back(i + lane);
+                        hits.push_back(lightIndex);
+                    }
+                }
+#else
+                for (uint32_t lane = i; lane < i + 4; ++lane) {
+                    float dx = std::max(std::max(minX[lane] - center.x, center.x - maxX[lane]), 0.0f);
+                    float dy = std::max(std::max(minY[lane] - center.y, center.y - maxY[lane]), 0.0f);
+                    float dz = std::max(std::max(minZ[lane] - center.z, center.z - maxZ[lane]), 0.0f);
+                    if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
+                        hits.push_back(lane);
+                        hits.push_back(lightIndex);
+                    }
+                }
+#endif
+            }
+        }
+    }
+
+    // Sortowanie przez zliczanie: listy klastrów leżą jedna za drugą w buforze indeksów
+    ranges.assign(CLUSTER_COUNT, { 0, 0 });
+    for (size_t i = 0; i < hits.size(); i += 2) {
+        ranges[hits[i]].count++;
+    }
+    uint32_t offset = 0;
+    for (ClusterRange& range : ranges) {
+        range.offset = offset;
+        offset += range.count;
+        range.count = 0;
+    }
+    lightIndices.resize(offset);
+    for (size_t i = 0; i < hits.size(); i += 2) {
+        ClusterRange& range = ranges[hits[i]];
+        lightIndices[range.offset + range.count++] = hits[i + 1];
+    }
+
+    uploadBuffer(lightBuffer, lightCapacity, POINT_LIGHT_BINDING, lights.data(), lights.size() * sizeof(PointLight));
+    uploadBuffer(rangeBuffer, rangeCapacity, CLUSTER_GRID_BINDING, ranges.data(), ranges.size() * sizeof(ClusterRange));
+    uploadBuffer(indexBuffer, indexCapacity, CLUSTER_INDEX_BINDING, lightIndices.data(), lightIndices.size() * sizeof(uint32_t));
+}
+
+void LightClusters::uploadBuffer(GLuint& buffer, GLsizeiptr& capacity, GLuint binding, const void* data, GLsizeiptr size) {
+    if (!buffer) {
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    if (size > capacity || capacity == 0) {
+        capacity = std::max<GLsizeiptr>(size * 2, 256);
+    }
+    // Osierocenie bufora - sterownik nie musi czekać na rysowanie z poprzedniej klatki
+    glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    if (size > 0) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+}
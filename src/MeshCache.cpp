@@ -0,0 +1,222 @@
+#include "MeshCache.h"
+#include "AssetLoader.h"
+#include "BitmapHandler.h"
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+std::unordered_map<std::string, std::weak_ptr<const MeshAsset>> MeshCache::entries;
+AssetLoader* MeshCache::loader = nullptr;
+
+namespace {
+    /**
+     * Model przygotowany do przesłania: bufory wskazują na zmapowany plik albo na baked.
+     */
+    struct LoadedModel {
+        MappedFile file;
+        std::vector<BakedMesh> baked;
+        ModelBlob blob;
+    };
+
+    /**
+     * Wczytuje model bez wywołań OpenGL - z pliku przetworzonego, a gdy go brak, przez import
+     * w threadCount wątkach (0 - wszystkie rdzenie).
+     */
+    bool loadModel(const std::string& path, unsigned int importFlags, LoadedModel& out, unsigned int threadCount) {
+        // Przetworzony plik jest wczytywany z mapowania pamięci, bez udziału Assimp
+        std::string cookedPath = CookedMesh::pathFor(path);
+        if (CookedMesh::isFresh(cookedPath, path)) {
+            if (out.file.open(cookedPath) && CookedMesh::read(out.file, importFlags, out.blob)) {
+                return true;
+            }
+            out.file.close();
+            out.blob = ModelBlob();
+        }
+
+        CpuModel model;
+        if (!MeshCache::importModel(path, importFlags, model, threadCount)) {
+            return false;
+        }
+        out.baked.resize(model.meshes.size());
+        out.blob.boundsMin = model.boundsMin;
+        out.blob.boundsMax = model.boundsMax;
+        for (size_t i = 0; i < model.meshes.size(); ++i) {
+            MeshCache::bake(model.meshes[i], out.baked[i]);
+            out.blob.meshes.push_back(out.baked[i].view());
+        }
+        return true;
+    }
+}
+
+MeshAsset::~MeshAsset() {
+    for (const GpuMesh& mesh : meshes) {
+        glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers(1, &mesh.VBO);
+        glDeleteBuffers(1, &mesh.EBO);
+        if (mesh.textureID != 0) {
+            BitmapHandler::releaseBitmap(mesh.textureID);
+        }
+    }
+}
+
+std::string MeshCache::makeKey(const std::string& path, unsigned int importFlags) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    std::string key = ec ? path : canonical.generic_string();
+    key += '|';
+    key += std::to_string(importFlags);
+    return key;
+}
+
+MeshHandle MeshCache::acquire(const std::string& path, unsigned int importFlags) {
+    std::string key = makeKey(path, importFlags);
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        if (MeshHandle existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    if (loader) {
+        // Pusty zasób trafia do cache od razu, więc kolejne obiekty z tym plikiem
+        // czekają na to samo wczytywanie
+        auto asset = std::make_shared<MeshAsset>();
+        std::weak_ptr<MeshAsset> target = asset;
+        loader->enqueue([target, path, importFlags]() -> AssetLoader::Completion {
+            if (target.expired()) {
+                return nullptr;
+            }
+            // Pula wczytuje modele równolegle - import w jednym wątku, bez tworzenia kolejnych
+            auto loaded = std::make_shared<LoadedModel>();
+            if (!loadModel(path, importFlags, *loaded, 1)) {
+                return nullptr;
+            }
+            return [target, loaded]() {
+                if (std::shared_ptr<MeshAsset> asset = target.lock()) {
+                    uploadInto(*asset, loaded->blob);
+                }
+            };
+        });
+        entries[key] = asset;
+        return asset;
+    }
+
+    LoadedModel loaded;
+    if (!loadModel(path, importFlags, loaded, 0)) {
+        return nullptr;
+    }
+    MeshHandle handle = upload(loaded.blob);
+    entries[key] = handle;
+    return handle;
+}
+
+void MeshCache::setLoader(AssetLoader* assetLoader) {
+    loader = assetLoader;
+}
+
+void MeshCache::setupPackedVertexAttributes() {
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+    glEnableVertexAttribArray(2);
+}
+
+MeshHandle MeshCache::upload(const CpuModel& model) {
+    std::vector<BakedMesh> baked(model.meshes.size());
+    ModelBlob blob;
+    blob.boundsMin = model.boundsMin;
+    blob.boundsMax = model.boundsMax;
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        bake(model.meshes[i], baked[i]);
+        blob.meshes.push_back(baked[i].view());
+    }
+    return upload(blob);
+}
+
+MeshHandle MeshCache::upload(const ModelBlob& model) {
+    auto asset = std::make_shared<MeshAsset>();
+    uploadInto(*asset, model);
+    return asset;
+}
+
+void MeshCache::uploadInto(MeshAsset& asset, const ModelBlob& model) {
+    asset.boundsMin = model.boundsMin;
+    asset.boundsMax = model.boundsMax;
+    asset.meshes.reserve(model.meshes.size());
+
+    for (const MeshBlob& blob : model.meshes) {
+        GpuMesh mesh;
+        glGenVertexArrays(1, &mesh.VAO);
+        glGenBuffers(1, &mesh.VBO);
+        glGenBuffers(1, &mesh.EBO);
+
+        glBindVertexArray(mesh.VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+        glBufferData(GL_ARRAY_BUFFER, blob.vertexBytes, blob.vertexData, GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, blob.indexBytes, blob.indexData, GL_STATIC_DRAW);
+
+        if (PACK_MESH_VERTICES) {
+            MeshCache::setupPackedVertexAttributes();
+        }
+        else {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)0);
+            glEnableVertexAttribArray(0);
+
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, texCoord));
+            glEnableVertexAttribArray(1);
+
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, normal));
+            glEnableVertexAttribArray(2);
+        }
+
+        RenderQueue::setupInstanceAttributes();
+
+        glBindVertexArray(0);
+
+        mesh.lods = blob.lods;
+        mesh.indexCount = mesh.lods.empty() ? 0 : mesh.lods[0].indexCount;
+        mesh.vertexCount = blob.vertexCount;
+        mesh.indexType = blob.indexType;
+        mesh.quantization = blob.quantization;
+
+        if (!blob.texturePath.empty()) {
+            mesh.textureID = BitmapHandler::loadBitmapFromFile(blob.texturePath);
+        }
+
+        if (asset.lodErrors.size() < mesh.lods.size()) {
+            asset.lodErrors.resize(mesh.lods.size(), 0.0f);
+        }
+        asset.meshes.push_back(mesh);
+    }
+
+    // Siatka bez danego poziomu rysuje swój najprostszy, więc jego błąd też się liczy
+    for (size_t level = 0; level < asset.lodErrors.size(); ++level) {
+        for (const GpuMesh& mesh : asset.meshes) {
+            const MeshLod& lod = mesh.lods[std::min(level, mesh.lods.size() - 1)];
+            asset.lodErrors[level] = std::max(asset.lodErrors[level], lod.error);
+        }
+    }
+
+    asset.ready = true;
+}
+
+size_t MeshCache::residentCount() {
+    size_t count = 0;
+    for (const auto& entry : entries) {
+        if (!entry.second.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
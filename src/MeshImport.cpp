@@ -0,0 +1,202 @@
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    /**
+     * Wczytuje siatki modelu przez Assimp (formaty inne niż OBJ lub OBJ nieobsłużony przez ObjLoader).
+     */
+    bool importWithAssimp(const std::string& path, unsigned int importFlags, CpuModel& out) {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path, importFlags);
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            std::cerr << "ASSIMP:: " << importer.GetErrorString() << std::endl;
+            return false;
+        }
+
+        out.meshes.reserve(scene->mNumMeshes);
+        for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+            const aiMesh* mesh = scene->mMeshes[m];
+            CpuMesh cpu;
+            cpu.vertices.reserve(mesh->mNumVertices);
+
+            for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+                MeshVertex vertex;
+                vertex.position = glm::vec3(mesh->mVertices[i].x,
+                    mesh->mVertices[i].y,
+                    mesh->mVertices[i].z);
+
+                vertex.normal = mesh->HasNormals() ? glm::vec3(mesh->mNormals[i].x,
+                    mesh->mNormals[i].y,
+                    mesh->mNormals[i].z) : glm::vec3(0.0f);
+
+                vertex.texCoord = mesh->HasTextureCoords(0) ? glm::vec2(mesh->mTextureCoords[0][i].x,
+                    mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f);
+
+                cpu.vertices.push_back(vertex);
+            }
+
+            cpu.indices.reserve(mesh->mNumFaces * 3);
+            for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+                const aiFace& face = mesh->mFaces[i];
+                for (unsigned int j = 0; j < face.mNumIndices; j++) {
+                    cpu.indices.push_back(face.mIndices[j]);
+                }
+            }
+
+            if (scene->HasMaterials()) {
+                aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+                if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+                    aiString str;
+                    material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
+
+                    cpu.texturePath = "models/";
+                    cpu.texturePath += std::string(str.C_Str());
+                }
+            }
+
+            out.meshes.push_back(std::move(cpu));
+        }
+        return true;
+    }
+}
+
+bool MeshCache::importModel(const std::string& path, unsigned int importFlags, CpuModel& out, unsigned int threadCount) {
+    // Pliki OBJ czytane są własnym parserem; Assimp zostaje dla pozostałych formatów
+    bool loaded = ObjLoader::canLoad(path) && ObjLoader::load(path, importFlags, out, threadCount);
+    if (!loaded) {
+        out.meshes.clear();
+        if (!importWithAssimp(path, importFlags, out)) {
+            return false;
+        }
+    }
+
+    bool first = true;
+    size_t triangles = 0;
+    float missesBefore = 0.0f;
+    float missesAfter = 0.0f;
+
+    for (CpuMesh& cpu : out.meshes) {
+        for (const MeshVertex& vertex : cpu.vertices) {
+            if (first) {
+                out.boundsMin = out.boundsMax = vertex.position;
+                first = false;
+            }
+            else {
+                out.boundsMin = glm::min(out.boundsMin, vertex.position);
+                out.boundsMax = glm::max(out.boundsMax, vertex.position);
+            }
+        }
+
+        MeshOptimizationStats stats = MeshOptimizer::optimize(cpu);
+        triangles += stats.triangles;
+        missesBefore += stats.acmrBefore * stats.triangles;
+        missesAfter += stats.acmrAfter * stats.triangles;
+    }
+
+    if (triangles > 0) {
+        std::cout << "Model " << path << ": " << triangles << " triangles, ACMR "
+            << missesBefore / triangles << " -> " << missesAfter / triangles << std::endl;
+    }
+
+    float radius = 0.5f * glm::length(out.boundsMax - out.boundsMin);
+    for (CpuMesh& mesh : out.meshes) {
+        generateLods(mesh, LOD_MAX_RELATIVE_ERROR * radius);
+    }
+
+    return true;
+}
+
+VertexQuantization MeshCache::quantizationFor(const std::vector<MeshVertex>& vertices) {
+    if (vertices.empty()) {
+        return VertexQuantization();
+    }
+    glm::vec3 boundsMin = vertices[0].position;
+    glm::vec3 boundsMax = vertices[0].position;
+    for (const MeshVertex& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    return VertexQuantization::fromBounds(boundsMin, boundsMax);
+}
+
+void MeshCache::generateLods(CpuMesh& mesh, float maxError) {
+    const std::vector<unsigned int>* previous = &mesh.indices;
+    float previousError = 0.0f;
+    while (mesh.lods.size() + 1 < MAX_LOD_LEVELS) {
+        size_t target = static_cast<size_t>(previous->size() / 3 * LOD_REDUCTION) * 3;
+        float error = 0.0f;
+        std::vector<unsigned int> simplified = MeshSimplifier::simplify(mesh.vertices, *previous, target,
+            maxError - previousError, &error);
+
+        // Poziom, który prawie nic nie upraszcza, nie jest wart miejsca w EBO
+        if (simplified.empty() || simplified.size() > previous->size() * 0.85f) {
+            break;
+        }
+        MeshOptimizer::optimizeVertexCache(simplified, mesh.vertices.size());
+
+        CpuLod lod;
+        lod.indices = std::move(simplified);
+        lod.error = previousError + error;
+        mesh.lods.push_back(std::move(lod));
+        previous = &mesh.lods.back().indices;
+        previousError = mesh.lods.back().error;
+    }
+}
+
+void MeshCache::bake(const CpuMesh& cpu, BakedMesh& out) {
+    out.info = MeshBlob();
+    out.info.vertexCount = static_cast<GLsizei>(cpu.vertices.size());
+    out.info.texturePath = cpu.texturePath;
+
+    if (PACK_MESH_VERTICES) {
+        out.info.quantization = quantizationFor(cpu.vertices);
+        out.vertexData.resize(cpu.vertices.size() * sizeof(PackedVertex));
+        PackedVertex* packed = reinterpret_cast<PackedVertex*>(out.vertexData.data());
+        for (size_t i = 0; i < cpu.vertices.size(); ++i) {
+            packed[i] = packVertex(cpu.vertices[i], out.info.quantization);
+        }
+    }
+    else {
+        out.vertexData.resize(cpu.vertices.size() * sizeof(MeshVertex));
+        std::memcpy(out.vertexData.data(), cpu.vertices.data(), out.vertexData.size());
+    }
+
+    // Poziomy szczegółowości leżą w EBO za pełną siatką
+    std::vector<unsigned int> allIndices = cpu.indices;
+    size_t indexSize = cpu.vertices.size() <= 65536 ? sizeof(uint16_t) : sizeof(unsigned int);
+    out.info.lods.push_back({ static_cast<GLsizei>(cpu.indices.size()), 0, 0.0f });
+    for (const CpuLod& lod : cpu.lods) {
+        out.info.lods.push_back({ static_cast<GLsizei>(lod.indices.size()), allIndices.size() * indexSize, lod.error });
+        allIndices.insert(allIndices.end(), lod.indices.begin(), lod.indices.end());
+    }
+
+    out.indexData.resize(allIndices.size() * indexSize);
+    if (indexSize == sizeof(uint16_t)) {
+        out.info.indexType = GL_UNSIGNED_SHORT;
+        uint16_t* shortIndices = reinterpret_cast<uint16_t*>(out.indexData.data());
+        for (size_t i = 0; i < allIndices.size(); ++i) {
+            shortIndices[i] = static_cast<uint16_t>(allIndices[i]);
+        }
+    }
+    else {
+        out.info.indexType = GL_UNSIGNED_INT;
+        std::memcpy(out.indexData.data(), allIndices.data(), out.indexData.size());
+    }
+}
+
+MeshBlob BakedMesh::view() const {
+    MeshBlob blob = info;
+    blob.vertexData = vertexData.data();
+    blob.vertexBytes = vertexData.size();
+    blob.indexData = indexData.data();
+    blob.indexBytes = indexData.size();
+    return blob;
+}
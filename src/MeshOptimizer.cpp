@@ -0,0 +1,397 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    // Parametry algorytmu Forsytha ("Linear-Speed Vertex Cache Optimisation")
+    constexpr int VCACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    constexpr uint32_t NO_TRIANGLE = ~0u;
+
+    float vertexScore(int cachePosition, uint32_t remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Wierzchołki ostatniego trójkąta dostają stałą ocenę, by nie faworyzować pasów
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else {
+                float scaler = 1.0f / (VCACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+        // Wierzchołki z niewieloma pozostałymi trójkątami warto domknąć jak najszybciej
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    struct VertexHash {
+        size_t operator()(const MeshVertex& vertex) const {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(MeshVertex); ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    struct VertexEqual {
+        bool operator()(const MeshVertex& a, const MeshVertex& b) const {
+            return std::memcmp(&a, &b, sizeof(MeshVertex)) == 0;
+        }
+    };
+
+    static_assert(sizeof(MeshVertex) == 8 * sizeof(float), "MeshVertex must not contain padding");
+
+    /**
+     * Symulowana pamięć FIFO wierzchołków; zwraca liczbę chybień dla trójkąta.
+     */
+    struct FifoCache {
+        std::vector<uint32_t> stamps;
+        uint32_t timestamp;
+        uint32_t size;
+
+        FifoCache(size_t vertexCount, size_t cacheSize)
+            : stamps(vertexCount, 0), timestamp(static_cast<uint32_t>(cacheSize) + 1), size(static_cast<uint32_t>(cacheSize)) {
+        }
+
+        unsigned int triangle(const unsigned int* corners) {
+            unsigned int misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                // Wierzchołek jest w pamięci, jeśli od jego wstawienia było mniej niż size chybień
+                if (timestamp - stamps[corners[k]] > size) {
+                    stamps[corners[k]] = timestamp++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+    };
+
+    glm::vec3 triangleCross(const std::vector<MeshVertex>& vertices, const unsigned int* corners) {
+        const glm::vec3& a = vertices[corners[0]].position;
+        const glm::vec3& b = vertices[corners[1]].position;
+        const glm::vec3& c = vertices[corners[2]].position;
+        return glm::cross(b - a, c - a);
+    }
+}
+
+MeshOptimizationStats MeshOptimizer::optimize(CpuMesh& mesh) {
+    MeshOptimizationStats stats;
+    stats.verticesBefore = mesh.vertices.size();
+    stats.triangles = mesh.indices.size() / 3;
+    stats.acmrBefore = computeACMR(mesh.indices, mesh.vertices.size());
+
+    if (mesh.indices.size() % 3 != 0) {
+        // Siatka nie składa się wyłącznie z trójkątów - zostawiamy ją bez zmian
+        stats.verticesAfter = stats.verticesBefore;
+        stats.acmrAfter = stats.acmrBefore;
+        return stats;
+    }
+
+    weldVertices(mesh);
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    optimizeOverdraw(mesh.indices, mesh.vertices);
+    optimizeVertexFetch(mesh);
+
+    stats.verticesAfter = mesh.vertices.size();
+    stats.acmrAfter = computeACMR(mesh.indices, mesh.vertices.size());
+    return stats;
+}
+
+void MeshOptimizer::weldVertices(CpuMesh& mesh) {
+    std::unordered_map<MeshVertex, unsigned int, VertexHash, VertexEqual> unique;
+    unique.reserve(mesh.vertices.size());
+
+    std::vector<unsigned int> remap(mesh.vertices.size());
+    std::vector<MeshVertex> welded;
+    welded.reserve(mesh.vertices.size());
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        auto inserted = unique.emplace(mesh.vertices[i], static_cast<unsigned int>(welded.size()));
+        if (inserted.second) {
+            welded.push_back(mesh.vertices[i]);
+        }
+        remap[i] = inserted.first->second;
+    }
+
+    if (welded.size() == mesh.vertices.size()) {
+        return;
+    }
+    for (unsigned int& index : mesh.indices) {
+        index = remap[index];
+    }
+    mesh.vertices = std::move(welded);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Listy trójkątów sąsiadujących z każdym wierzchołkiem (CSR)
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (unsigned int index : indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        score[v] = vertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<char> emitted(triangleCount, 0);
+    uint32_t best = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) {
+            best = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(VCACHE_SIZE + 3);
+    nextCache.reserve(VCACHE_SIZE + 3);
+    size_t cursor = 0;
+
+    while (best != NO_TRIANGLE) {
+        const unsigned int* corners = &indices[best * 3];
+        emitted[best] = 1;
+        result.insert(result.end(), corners, corners + 3);
+
+        // Wierzchołki trójkąta trafiają na początek pamięci LRU
+        nextCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(nextCache.begin(), nextCache.end(), corners[k]) == nextCache.end()) {
+                nextCache.push_back(corners[k]);
+            }
+        }
+        for (uint32_t vertex : cache) {
+            if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+        cache.swap(nextCache);
+
+        // Usunięcie trójkąta z list sąsiedztwa jego wierzchołków
+        for (int k = 0; k < 3; ++k) {
+            uint32_t vertex = corners[k];
+            uint32_t* list = &adjacency[adjacencyOffset[vertex]];
+            uint32_t count = remaining[vertex];
+            for (uint32_t i = 0; i < count; ++i) {
+                if (list[i] == best) {
+                    list[i] = list[count - 1];
+                    break;
+                }
+            }
+            remaining[vertex]--;
+        }
+
+        // Nowe oceny wierzchołków w pamięci (także wypchniętych) i ich trójkątów
+        best = NO_TRIANGLE;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < cache.size(); ++i) {
+            uint32_t vertex = cache[i];
+            int position = i < static_cast<size_t>(VCACHE_SIZE) ? static_cast<int>(i) : -1;
+            float newScore = vertexScore(position, remaining[vertex]);
+            float delta = newScore - score[vertex];
+            score[vertex] = newScore;
+
+            const uint32_t* list = &adjacency[adjacencyOffset[vertex]];
+            for (uint32_t j = 0; j < remaining[vertex]; ++j) {
+                uint32_t triangle = list[j];
+                triangleScore[triangle] += delta;
+                if (triangleScore[triangle] > bestScore) {
+                    bestScore = triangleScore[triangle];
+                    best = triangle;
+                }
+            }
+        }
+        if (cache.size() > static_cast<size_t>(VCACHE_SIZE)) {
+            cache.resize(VCACHE_SIZE);
+        }
+
+        if (best == NO_TRIANGLE) {
+            // Pamięć nie sąsiaduje z żadnym trójkątem - kolejny nieużyty trójkąt w kolejności pliku
+            while (cursor < triangleCount && emitted[cursor]) {
+                ++cursor;
+            }
+            if (cursor < triangleCount) {
+                best = static_cast<uint32_t>(cursor);
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<MeshVertex>& vertices,
+    float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // Twarde granice: trójkąt, którego wszystkie wierzchołki chybiły, zaczyna nowy fragment
+    std::vector<uint32_t> hardBoundaries;
+    {
+        FifoCache cache(vertices.size(), FIFO_CACHE_SIZE);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (cache.triangle(&indices[t * 3]) == 3) {
+                hardBoundaries.push_back(static_cast<uint32_t>(t));
+            }
+        }
+        if (hardBoundaries.empty() || hardBoundaries.front() != 0) {
+            hardBoundaries.insert(hardBoundaries.begin(), 0);
+        }
+    }
+
+    // Miękkie granice: fragment dzielony tam, gdzie narastający ACMR wraca blisko ACMR fragmentu
+    std::vector<uint32_t> clusters;
+    {
+        FifoCache cache(vertices.size(), FIFO_CACHE_SIZE);
+        std::vector<unsigned int> misses(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            misses[t] = cache.triangle(&indices[t * 3]);
+        }
+
+        for (size_t h = 0; h < hardBoundaries.size(); ++h) {
+            uint32_t begin = hardBoundaries[h];
+            uint32_t end = h + 1 < hardBoundaries.size() ? hardBoundaries[h + 1] : static_cast<uint32_t>(triangleCount);
+
+            unsigned int clusterMisses = 0;
+            for (uint32_t t = begin; t < end; ++t) {
+                clusterMisses += misses[t];
+            }
+            float clusterThreshold = threshold * clusterMisses / (end - begin);
+
+            clusters.push_back(begin);
+            uint32_t start = begin;
+            unsigned int runningMisses = 0;
+            for (uint32_t t = begin; t < end; ++t) {
+                runningMisses += misses[t];
+                if (t + 1 < end && static_cast<float>(runningMisses) / (t - start + 1) <= clusterThreshold) {
+                    clusters.push_back(t + 1);
+                    start = t + 1;
+                    runningMisses = 0;
+                }
+            }
+        }
+    }
+
+    if (clusters.size() < 2) {
+        return;
+    }
+
+    // Środek siatki ważony polem trójkątów
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* corners = &indices[t * 3];
+        float area = glm::length(triangleCross(vertices, corners));
+        meshCenter += (vertices[corners[0]].position + vertices[corners[1]].position + vertices[corners[2]].position) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) {
+        meshCenter /= meshArea;
+    }
+
+    // Klastry zwrócone na zewnątrz siatki zasłaniają pozostałe, więc idą pierwsze
+    struct ClusterOrder {
+        float key;
+        uint32_t begin;
+        uint32_t end;
+    };
+    std::vector<ClusterOrder> order(clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        uint32_t begin = clusters[c];
+        uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (uint32_t t = begin; t < end; ++t) {
+            const unsigned int* corners = &indices[t * 3];
+            glm::vec3 cross = triangleCross(vertices, corners);
+            float triangleArea = glm::length(cross);
+            center += (vertices[corners[0]].position + vertices[corners[1]].position + vertices[corners[2]].position) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+        if (area > 0.0f) {
+            center /= area;
+        }
+        float normalLength = glm::length(normal);
+        if (normalLength > 0.0f) {
+            normal /= normalLength;
+        }
+        order[c] = { glm::dot(center - meshCenter, normal), begin, end };
+    }
+
+    std::stable_sort(order.begin(), order.end(), [](const ClusterOrder& a, const ClusterOrder& b) {
+        return a.key > b.key;
+    });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const ClusterOrder& cluster : order) {
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(CpuMesh& mesh) {
+    constexpr unsigned int UNUSED = ~0u;
+    std::vector<unsigned int> remap(mesh.vertices.size(), UNUSED);
+    std::vector<MeshVertex> ordered;
+    ordered.reserve(mesh.vertices.size());
+
+    for (unsigned int& index : mesh.indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<unsigned int>(ordered.size());
+            ordered.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(ordered);
+}
+
+float MeshOptimizer::computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        misses += cache.triangle(&indices[t * 3]);
+    }
+    return static_cast<float>(misses) / triangleCount;
+}
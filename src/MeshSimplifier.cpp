@@ -0,0 +1,264 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    /**
+     * Symetryczna kwadryka 4x4: błąd(p) = p^T A p + 2 b.p + c.
+     */
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0;
+        double c = 0;
+
+        static Quadric fromPlane(const glm::vec3& normal, float distance) {
+            Quadric q;
+            double x = normal.x, y = normal.y, z = normal.z, d = distance;
+            q.a00 = x * x; q.a01 = x * y; q.a02 = x * z;
+            q.a11 = y * y; q.a12 = y * z; q.a22 = z * z;
+            q.b0 = x * d; q.b1 = y * d; q.b2 = z * d;
+            q.c = d * d;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            return *this;
+        }
+
+        double evaluate(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double result = a00 * x * x + a11 * y * y + a22 * z * z
+                + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& position) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &position, sizeof(bits));
+            return static_cast<size_t>(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+        }
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double cost;
+    };
+
+    /**
+     * Oznacza wierzchołki, których nie wolno przesuwać: brzegowe i leżące na szwach atrybutów.
+     */
+    std::vector<char> findLockedVertices(const std::vector<MeshVertex>& vertices, const std::vector<unsigned int>& indices) {
+        std::vector<char> locked(vertices.size(), 0);
+
+        std::unordered_map<glm::vec3, unsigned int, PositionHash> firstAtPosition;
+        firstAtPosition.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto inserted = firstAtPosition.emplace(vertices[i].position, static_cast<unsigned int>(i));
+            if (!inserted.second) {
+                locked[i] = 1;
+                locked[inserted.first->second] = 1;
+            }
+        }
+
+        // Krawędź używana przez jeden trójkąt leży na brzegu siatki
+        std::unordered_map<uint64_t, unsigned int> edgeUses;
+        edgeUses.reserve(indices.size());
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            for (int k = 0; k < 3; ++k) {
+                uint64_t a = indices[t + k];
+                uint64_t b = indices[t + (k + 1) % 3];
+                edgeUses[a < b ? (a << 32 | b) : (b << 32 | a)]++;
+            }
+        }
+        for (const auto& edge : edgeUses) {
+            if (edge.second == 1) {
+                locked[edge.first >> 32] = 1;
+                locked[edge.first & 0xFFFFFFFFu] = 1;
+            }
+        }
+        return locked;
+    }
+
+    /**
+     * Sprawdza, czy przeniesienie wierzchołka from na pozycję to odwraca któryś z jego trójkątów.
+     */
+    bool flipsTriangle(const std::vector<MeshVertex>& vertices, const std::vector<unsigned int>& indices,
+        const uint32_t* triangles, uint32_t triangleCount, unsigned int from, unsigned int to) {
+        const glm::vec3& target = vertices[to].position;
+        for (uint32_t i = 0; i < triangleCount; ++i) {
+            const unsigned int* corners = &indices[triangles[i] * 3];
+            if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                continue;  // trójkąt znika razem ze zwijaną krawędzią
+            }
+            glm::vec3 p[3];
+            glm::vec3 moved[3];
+            for (int k = 0; k < 3; ++k) {
+                p[k] = vertices[corners[k]].position;
+                moved[k] = corners[k] == from ? target : p[k];
+            }
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+            if (glm::dot(before, after) <= 0.0f) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<MeshVertex>& vertices,
+    const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, float* resultError) {
+    std::vector<unsigned int> result = indices;
+    double usedCost = 0.0;
+    const size_t vertexCount = vertices.size();
+
+    std::vector<char> locked = findLockedVertices(vertices, indices);
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const glm::vec3& p0 = vertices[indices[t]].position;
+        glm::vec3 normal = glm::cross(vertices[indices[t + 1]].position - p0, vertices[indices[t + 2]].position - p0);
+        float length = glm::length(normal);
+        if (length == 0.0f) {
+            continue;
+        }
+        normal /= length;
+        Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, p0));
+        for (int k = 0; k < 3; ++k) {
+            quadrics[indices[t + k]] += plane;
+        }
+    }
+
+    const double maxCost = static_cast<double>(maxError) * maxError;
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> fill;
+    std::vector<Collapse> candidates;
+    std::vector<unsigned int> collapseTo(vertexCount);
+    std::vector<char> touched(vertexCount);
+
+    // Zwinięcia wykonywane są przebiegami: w każdym najtańsze niezależne krawędzie
+    while (result.size() > targetIndexCount) {
+        const size_t triangleCount = result.size() / 3;
+
+        std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+        for (unsigned int index : result) {
+            adjacencyOffset[index + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            adjacencyOffset[v + 1] += adjacencyOffset[v];
+        }
+        adjacency.resize(result.size());
+        fill.assign(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                adjacency[fill[result[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+
+        // Najtańsze zwinięcie dla każdego ruchomego wierzchołka
+        candidates.clear();
+        for (size_t v = 0; v < vertexCount; ++v) {
+            if (locked[v] || adjacencyOffset[v] == adjacencyOffset[v + 1]) {
+                continue;
+            }
+            Collapse best{ static_cast<unsigned int>(v), 0, -1.0 };
+            for (uint32_t i = adjacencyOffset[v]; i < adjacencyOffset[v + 1]; ++i) {
+                const unsigned int* corners = &result[adjacency[i] * 3];
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int neighbour = corners[k];
+                    if (neighbour == v) {
+                        continue;
+                    }
+                    Quadric combined = quadrics[v];
+                    combined += quadrics[neighbour];
+                    double cost = combined.evaluate(vertices[neighbour].position);
+                    if (best.cost < 0.0 || cost < best.cost) {
+                        best.to = neighbour;
+                        best.cost = cost;
+                    }
+                }
+            }
+            if (best.cost >= 0.0 && best.cost <= maxCost) {
+                candidates.push_back(best);
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost;
+        });
+
+        for (size_t v = 0; v < vertexCount; ++v) {
+            collapseTo[v] = static_cast<unsigned int>(v);
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t remainingIndices = result.size();
+        size_t collapses = 0;
+
+        for (const Collapse& collapse : candidates) {
+            if (remainingIndices <= targetIndexCount) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+            const uint32_t* triangles = &adjacency[adjacencyOffset[collapse.from]];
+            uint32_t count = adjacencyOffset[collapse.from + 1] - adjacencyOffset[collapse.from];
+            if (flipsTriangle(vertices, result, triangles, count, collapse.from, collapse.to)) {
+                continue;
+            }
+
+            collapseTo[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            usedCost = std::max(usedCost, collapse.cost);
+            ++collapses;
+
+            // Otoczenie zwiniętego wierzchołka nie zmienia się więcej w tym przebiegu
+            for (uint32_t i = 0; i < count; ++i) {
+                const unsigned int* corners = &result[triangles[i] * 3];
+                bool removed = false;
+                for (int k = 0; k < 3; ++k) {
+                    touched[corners[k]] = 1;
+                    removed = removed || corners[k] == collapse.to;
+                }
+                if (removed) {
+                    remainingIndices -= 3;
+                }
+            }
+        }
+        if (collapses == 0) {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            unsigned int a = collapseTo[result[t * 3]];
+            unsigned int b = collapseTo[result[t * 3 + 1]];
+            unsigned int c = collapseTo[result[t * 3 + 2]];
+            if (a != b && b != c && a != c) {
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    if (resultError) {
+        *resultError = static_cast<float>(std::sqrt(usedCost));
+    }
+    return result;
+}
@@ -0,0 +1,100 @@
+#include "MipChain.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPCHAIN_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    /**
+     * Sumuje dwa wiersze źródłowe bajt po bajcie do bufora 16-bitowego.
+     */
+    void sumRows(const uint8_t* a, const uint8_t* b, uint16_t* sum, size_t count) {
+        size_t i = 0;
+#ifdef MIPCHAIN_USE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16) {
+            __m128i rowA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i rowB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sum + i),
+                _mm_add_epi16(_mm_unpacklo_epi8(rowA, zero), _mm_unpacklo_epi8(rowB, zero)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sum + i + 8),
+                _mm_add_epi16(_mm_unpackhi_epi8(rowA, zero), _mm_unpackhi_epi8(rowB, zero)));
+        }
+#endif
+        for (; i < count; ++i) {
+            sum[i] = static_cast<uint16_t>(a[i] + b[i]);
+        }
+    }
+
+    /**
+     * Uśrednia pary sąsiednich pikseli sumy dwóch wierszy (cztery próbki na piksel wyjściowy).
+     */
+    void averagePairs(const uint16_t* sum, uint8_t* out, int outWidth, int channels) {
+        int x = 0;
+#ifdef MIPCHAIN_USE_SSE2
+        if (channels == 4) {
+            // Dwa piksele wyjściowe na iterację: połówki rejestrów to sąsiednie piksele źródłowe
+            const __m128i rounding = _mm_set1_epi16(2);
+            for (; x + 2 <= outWidth; x += 2) {
+                __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + x * 8));
+                __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + x * 8 + 8));
+                __m128i total = _mm_add_epi16(_mm_unpacklo_epi64(first, second), _mm_unpackhi_epi64(first, second));
+                total = _mm_srli_epi16(_mm_add_epi16(total, rounding), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(total, total));
+            }
+        }
+#endif
+        for (; x < outWidth; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                out[x * channels + c] = static_cast<uint8_t>(
+                    (sum[(2 * x) * channels + c] + sum[(2 * x + 1) * channels + c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+void MipChain::build(const unsigned char* pixels, int width, int height, int channels, MipChain& out) {
+    out.channels = channels;
+    out.levels.clear();
+
+    size_t total = 0;
+    for (int w = width, h = height; ; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        MipLevel level;
+        level.width = w;
+        level.height = h;
+        level.offset = total;
+        level.size = static_cast<size_t>(w) * h * channels;
+        out.levels.push_back(level);
+        total += level.size;
+        if (w == 1 && h == 1) {
+            break;
+        }
+    }
+
+    out.data.resize(total);
+    std::memcpy(out.data.data(), pixels, out.levels[0].size);
+
+    // Suma wierszy ma zawsze co najmniej dwa piksele - obraz o szerokości 1 powiela kolumnę
+    std::vector<uint16_t> sum(static_cast<size_t>(std::max(width, 2)) * channels);
+    for (size_t i = 1; i < out.levels.size(); ++i) {
+        const MipLevel& source = out.levels[i - 1];
+        const MipLevel& target = out.levels[i];
+        const uint8_t* src = out.data.data() + source.offset;
+        uint8_t* dst = out.data.data() + target.offset;
+        size_t sourceRow = static_cast<size_t>(source.width) * channels;
+
+        for (int y = 0; y < target.height; ++y) {
+            const uint8_t* rowA = src + std::min(2 * y, source.height - 1) * sourceRow;
+            const uint8_t* rowB = src + std::min(2 * y + 1, source.height - 1) * sourceRow;
+            sumRows(rowA, rowB, sum.data(), sourceRow);
+            if (source.width == 1) {
+                std::copy(sum.begin(), sum.begin() + channels, sum.begin() + channels);
+            }
+            averagePairs(sum.data(), dst + static_cast<size_t>(y) * target.width * channels, target.width, channels);
+        }
+    }
+}
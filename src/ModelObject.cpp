@@ -1,130 +1,74 @@
 #include "ModelObject.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 
-ModelObject::ModelObject(const std::string& path) {
-    loadModel(path);
+ModelObject::ModelObject(const std::string& path)
+    : asset(MeshCache::acquire(path)) {
 }
 
-void ModelObject::loadModel(const std::string& path) {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path,
-        aiProcess_Triangulate |
-        aiProcess_GenSmoothNormals |
-        aiProcess_FlipUVs |
-        aiProcess_CalcTangentSpace);
-
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        std::cerr << "ASSIMP:: " << importer.GetErrorString() << std::endl;
-        return;
-    }
-
-    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
-        Mesh mesh = processMesh(scene->mMeshes[i], scene);
-        setupMesh(mesh);
-        meshes.push_back(mesh);
+BoundingSphere ModelObject::getBoundingSphere() const {
+    if (!localBounds.isValid() && isLoaded()) {
+        localBounds = BoundingSphere::fromBounds(asset->boundsMin, asset->boundsMax);
     }
+    return localBounds;
 }
 
-ModelObject::Mesh ModelObject::processMesh(aiMesh* mesh, const aiScene* scene) {
-    Mesh out;
-
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-        Vertex vertex;
-        vertex.position = glm::vec3(mesh->mVertices[i].x,
-            mesh->mVertices[i].y,
-            mesh->mVertices[i].z);
-
-        vertex.normal = mesh->HasNormals() ? glm::vec3(mesh->mNormals[i].x,
-            mesh->mNormals[i].y,
-            mesh->mNormals[i].z) : glm::vec3(0.0f);
 
-        vertex.texCoord = mesh->HasTextureCoords(0) ? glm::vec2(mesh->mTextureCoords[0][i].x,
-            mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f);
+void ModelObject::submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const {
+    if (!asset) return;
 
-        out.vertices.push_back(vertex);
-    }
+    glm::vec3 center = glm::vec3(model[3]);
+    size_t level = selectLod(queue, pass, model);
 
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++) {
-            out.indices.push_back(face.mIndices[j]);
+    for (const GpuMesh& mesh : asset->meshes) {
+        DrawPacket packet;
+        packet.shader = &shader;
+        packet.vao = mesh.VAO;
+        packet.texture = mesh.textureID;
+        packet.indexCount = mesh.indexCount;
+        if (!mesh.lods.empty()) {
+            const MeshLod& lod = mesh.lods[std::min(level, mesh.lods.size() - 1)];
+            packet.indexCount = lod.indexCount;
+            packet.indexOffset = lod.indexOffset;
         }
+        packet.indexType = mesh.indexType;
+        packet.quantization = mesh.quantization;
+        packet.model = model;
+        queue.submit(pass, packet, center);
     }
-
-    if (scene && scene->HasMaterials()) {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
-            aiString str;
-            material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
-
-            std::string path = "models/";
-            path += std::string(str.C_Str());
-
-            out.textureID = BitmapHandler::loadBitmapFromFile(path);
-            std::cout << "Loaded texture: " << path << std::endl;
-        }
-    }
-
-    return out;
 }
 
 
-void ModelObject::setupMesh(Mesh& mesh) {
-    glGenVertexArrays(1, &mesh.VAO);
-    glGenBuffers(1, &mesh.VBO);
-    glGenBuffers(1, &mesh.EBO);
-
-    glBindVertexArray(mesh.VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), mesh.vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
-}
-
-
-void ModelObject::draw(GLuint shaderProgram,
-    const glm::mat4& model,
-    const glm::mat4& view,
-    const glm::mat4& projection) {
-    glUseProgram(shaderProgram);
-
-    GLuint modelLoc = glGetUniformLocation(shaderProgram, "model");
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-    for (const Mesh& mesh : meshes) {
-        if (mesh.textureID != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mesh.textureID);
-            glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-        }
-
-        glBindVertexArray(mesh.VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indices.size()), GL_UNSIGNED_INT, 0);
+size_t ModelObject::selectLod(const RenderQueue& queue, RenderPass pass, const glm::mat4& model) const {
+    if (!asset || asset->lodErrors.size() < 2 || pass == RenderPass::Overlay || queue.getLodProjection() <= 0.0f) {
+        return 0;
     }
 
-    glBindVertexArray(0);
+    // Liczba pikseli na jednostkę przestrzeni lokalnej w miejscu obiektu
+    float scale = std::max(glm::length(glm::vec3(model[0])),
+        std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    BoundingSphere bounds = getBoundingSphere();
+    glm::vec3 center = bounds.isValid() ? bounds.transformed(model).center : glm::vec3(model[3]);
+    float distance = std::max(glm::length(center - queue.getViewPosition()), 1e-3f);
+    float pixelsPerUnit = scale * queue.getLodProjection() / distance;
+
+    bool shadow = isShadowPass(pass);
+    float tolerance = shadow ? SHADOW_LOD_PIXEL_ERROR : LOD_PIXEL_ERROR;
+    const std::vector<float>& errors = asset->lodErrors;
+    size_t& current = lodLevel[shadow ? 1 : 0];
+    current = std::min(current, errors.size() - 1);
+
+    while (current + 1 < errors.size() && errors[current + 1] * pixelsPerUnit <= tolerance * (1.0f - LOD_HYSTERESIS)) {
+        ++current;
+    }
+    while (current > 0 && errors[current] * pixelsPerUnit > tolerance * (1.0f + LOD_HYSTERESIS)) {
+        --current;
+    }
+    return current;
 }
 
-
 void ModelObject::setPosition(const glm::vec3& pos) {
     position = pos;
 }
@@ -0,0 +1,469 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    constexpr int32_t NO_INDEX = INT32_MIN;
+    constexpr size_t MIN_CHUNK_BYTES = 64 * 1024;
+
+    constexpr uint8_t RELATIVE_POSITION = 1;
+    constexpr uint8_t RELATIVE_TEXCOORD = 2;
+    constexpr uint8_t RELATIVE_NORMAL = 4;
+
+    /**
+     * Narożnik ściany: indeksy pozycji, współrzędnych tekstury i normalnej (od 0).
+     * Indeksy ujemne z pliku zapisywane są względem początku fragmentu i oznaczane
+     * bitem w relative, dopóki scalenie nie zamieni ich na bezwzględne.
+     */
+    struct Corner {
+        int32_t position;
+        int32_t texCoord;
+        int32_t normal;
+        uint8_t relative;
+    };
+
+    struct MaterialSwitch {
+        size_t face;       /**< Pierwsza ściana z materiałem (indeks w fragmencie/pliku). */
+        std::string name;  /**< Nazwa materiału. */
+    };
+
+    struct Chunk {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> texCoords;
+        std::vector<Corner> corners;
+        std::vector<uint32_t> faceSizes;
+        std::vector<MaterialSwitch> materials;
+        std::vector<std::string> libraries;
+        bool valid = true;
+    };
+
+    const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+        return p;
+    }
+
+    std::string restOfLine(const char* p, const char* end) {
+        p = skipSpaces(p, end);
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+            --end;
+        }
+        return std::string(p, end);
+    }
+
+    bool parseFloat(const char*& p, const char* end, float& value) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+') {
+            ++p;
+        }
+        std::from_chars_result result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+        return true;
+    }
+
+    /**
+     * Zamienia indeks z pliku (od 1 lub ujemny) na indeks od 0; ujemne liczone są
+     * względem liczby elementów wczytanych dotąd w fragmencie.
+     */
+    int32_t decodeIndex(int value, size_t localCount, uint8_t flag, uint8_t& relative) {
+        if (value > 0) {
+            return value - 1;
+        }
+        relative |= flag;
+        return static_cast<int32_t>(localCount) + value;
+    }
+
+    bool parseCorner(const char*& p, const char* end, Chunk& chunk, Corner& corner) {
+        int value = 0;
+        std::from_chars_result result = std::from_chars(p, end, value);
+        if (result.ec != std::errc() || value == 0) {
+            return false;
+        }
+        p = result.ptr;
+        corner = { 0, NO_INDEX, NO_INDEX, 0 };
+        corner.position = decodeIndex(value, chunk.positions.size(), RELATIVE_POSITION, corner.relative);
+
+        if (p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/') {
+                result = std::from_chars(p, end, value);
+                if (result.ec != std::errc() || value == 0) {
+                    return false;
+                }
+                p = result.ptr;
+                corner.texCoord = decodeIndex(value, chunk.texCoords.size(), RELATIVE_TEXCOORD, corner.relative);
+            }
+            if (p < end && *p == '/') {
+                ++p;
+                result = std::from_chars(p, end, value);
+                if (result.ec != std::errc() || value == 0) {
+                    return false;
+                }
+                p = result.ptr;
+                corner.normal = decodeIndex(value, chunk.normals.size(), RELATIVE_NORMAL, corner.relative);
+            }
+        }
+        return true;
+    }
+
+    bool startsWith(const char* p, const char* end, const char* keyword) {
+        size_t length = std::strlen(keyword);
+        return static_cast<size_t>(end - p) > length && std::memcmp(p, keyword, length) == 0
+            && (p[length] == ' ' || p[length] == '\t');
+    }
+
+    void parseChunk(const char* begin, const char* end, bool flipUVs, Chunk& chunk) {
+        const char* line = begin;
+        while (line < end && chunk.valid) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            const char* p = skipSpaces(line, lineEnd);
+
+            if (startsWith(p, lineEnd, "v")) {
+                glm::vec3 position;
+                p += 1;
+                chunk.valid = parseFloat(p, lineEnd, position.x) && parseFloat(p, lineEnd, position.y)
+                    && parseFloat(p, lineEnd, position.z);
+                chunk.positions.push_back(position);
+            }
+            else if (startsWith(p, lineEnd, "vt")) {
+                glm::vec2 texCoord(0.0f);
+                p += 2;
+                chunk.valid = parseFloat(p, lineEnd, texCoord.x);
+                // Druga współrzędna bywa pominięta w plikach z teksturami 1D
+                if (!parseFloat(p, lineEnd, texCoord.y)) {
+                    texCoord.y = 0.0f;
+                }
+                if (flipUVs) {
+                    texCoord.y = 1.0f - texCoord.y;
+                }
+                chunk.texCoords.push_back(texCoord);
+            }
+            else if (startsWith(p, lineEnd, "vn")) {
+                glm::vec3 normal;
+                p += 2;
+                chunk.valid = parseFloat(p, lineEnd, normal.x) && parseFloat(p, lineEnd, normal.y)
+                    && parseFloat(p, lineEnd, normal.z);
+                chunk.normals.push_back(normal);
+            }
+            else if (startsWith(p, lineEnd, "f")) {
+                p += 1;
+                uint32_t count = 0;
+                while (true) {
+                    p = skipSpaces(p, lineEnd);
+                    if (p >= lineEnd || *p == '\r') {
+                        break;
+                    }
+                    Corner corner;
+                    if (!parseCorner(p, lineEnd, chunk, corner)) {
+                        chunk.valid = false;
+                        break;
+                    }
+                    chunk.corners.push_back(corner);
+                    ++count;
+                }
+                chunk.faceSizes.push_back(count);
+            }
+            else if (startsWith(p, lineEnd, "usemtl")) {
+                chunk.materials.push_back({ chunk.faceSizes.size(), restOfLine(p + 6, lineEnd) });
+            }
+            else if (startsWith(p, lineEnd, "mtllib")) {
+                chunk.libraries.push_back(restOfLine(p + 6, lineEnd));
+            }
+
+            line = lineEnd + 1;
+        }
+    }
+
+    /**
+     * Wczytuje ścieżki tekstur diffuse (map_Kd) materiałów z pliku MTL.
+     */
+    void parseMaterialLibrary(const std::string& path, std::unordered_map<std::string, std::string>& textures) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "OBJ: cannot open material library " << path << std::endl;
+            return;
+        }
+        const char* line = reinterpret_cast<const char*>(file.data());
+        const char* end = line + file.size();
+        std::string current;
+        while (line < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            const char* p = skipSpaces(line, lineEnd);
+            if (startsWith(p, lineEnd, "newmtl")) {
+                current = restOfLine(p + 6, lineEnd);
+            }
+            else if (startsWith(p, lineEnd, "map_Kd")) {
+                textures[current] = restOfLine(p + 6, lineEnd);
+            }
+            line = lineEnd + 1;
+        }
+    }
+
+    struct CornerHash {
+        size_t operator()(const Corner& corner) const {
+            uint64_t hash = static_cast<uint32_t>(corner.position) * 0x9E3779B97F4A7C15ull;
+            hash ^= (static_cast<uint32_t>(corner.texCoord) + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull;
+            hash ^= (static_cast<uint32_t>(corner.normal) + 0x94D049BB133111EBull) * 0x94D049BB133111EBull;
+            return static_cast<size_t>(hash ^ (hash >> 31));
+        }
+    };
+
+    struct CornerEqual {
+        bool operator()(const Corner& a, const Corner& b) const {
+            return a.position == b.position && a.texCoord == b.texCoord && a.normal == b.normal;
+        }
+    };
+
+    /**
+     * Łączy identyczne narożniki w wierzchołki. Wątek t obsługuje narożniki, których
+     * skrót trafia do części t, więc mapy wątków są rozłączne i nie wymagają blokad.
+     */
+    void buildVertices(const std::vector<Corner>& corners, const std::vector<glm::vec3>& positions,
+        const std::vector<glm::vec3>& normals, const std::vector<glm::vec2>& texCoords,
+        unsigned int threadCount, CpuMesh& mesh) {
+        std::vector<uint32_t> shardOf(corners.size());
+        std::vector<uint32_t> localIndex(corners.size());
+        std::vector<std::vector<Corner>> unique(threadCount);
+
+        auto work = [&](unsigned int shard) {
+            std::unordered_map<Corner, uint32_t, CornerHash, CornerEqual> map;
+            map.reserve(corners.size() / threadCount + 1);
+            CornerHash hasher;
+            for (size_t i = 0; i < corners.size(); ++i) {
+                size_t hash = hasher(corners[i]);
+                if (hash % threadCount != shard) {
+                    continue;
+                }
+                auto inserted = map.emplace(corners[i], static_cast<uint32_t>(unique[shard].size()));
+                if (inserted.second) {
+                    unique[shard].push_back(corners[i]);
+                }
+                shardOf[i] = shard;
+                localIndex[i] = inserted.first->second;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int shard = 1; shard < threadCount; ++shard) {
+            threads.emplace_back(work, shard);
+        }
+        work(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        std::vector<uint32_t> base(threadCount, 0);
+        size_t vertexCount = 0;
+        for (unsigned int shard = 0; shard < threadCount; ++shard) {
+            base[shard] = static_cast<uint32_t>(vertexCount);
+            vertexCount += unique[shard].size();
+        }
+
+        mesh.vertices.resize(vertexCount);
+        for (unsigned int shard = 0; shard < threadCount; ++shard) {
+            for (size_t i = 0; i < unique[shard].size(); ++i) {
+                const Corner& corner = unique[shard][i];
+                MeshVertex& vertex = mesh.vertices[base[shard] + i];
+                vertex.position = positions[corner.position];
+                vertex.normal = corner.normal != NO_INDEX ? normals[corner.normal] : glm::vec3(0.0f);
+                vertex.texCoord = corner.texCoord != NO_INDEX ? texCoords[corner.texCoord] : glm::vec2(0.0f);
+            }
+        }
+        mesh.indices.resize(corners.size());
+        for (size_t i = 0; i < corners.size(); ++i) {
+            mesh.indices[i] = base[shardOf[i]] + localIndex[i];
+        }
+    }
+}
+
+bool ObjLoader::canLoad(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return extension == ".obj";
+}
+
+bool ObjLoader::load(const std::string& path, unsigned int importFlags, CpuModel& out, unsigned int threadCount) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+
+    // Fragmenty kończą się na końcu linii, więc żadna linia nie jest dzielona
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, file.size() / MIN_CHUNK_BYTES));
+    std::vector<const char*> bounds(chunkCount + 1, end);
+    bounds[0] = data;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* split = std::max(bounds[i - 1], data + file.size() * i / chunkCount);
+        const char* newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+        bounds[i] = newline ? newline + 1 : end;
+    }
+
+    bool flipUVs = (importFlags & aiProcess_FlipUVs) != 0;
+    std::vector<Chunk> chunks(chunkCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        threads.emplace_back(parseChunk, bounds[i], bounds[i + 1], flipUVs, std::ref(chunks[i]));
+    }
+    parseChunk(bounds[0], bounds[1], flipUVs, chunks[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Scalenie fragmentów i rozwiązanie indeksów względem liczności wcześniejszych fragmentów
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<Corner> corners;
+    std::vector<uint32_t> faceSizes;
+    std::vector<MaterialSwitch> materials;
+    std::vector<std::string> libraries;
+    for (Chunk& chunk : chunks) {
+        if (!chunk.valid) {
+            std::cerr << "OBJ: malformed file " << path << std::endl;
+            return false;
+        }
+        int32_t positionBase = static_cast<int32_t>(positions.size());
+        int32_t normalBase = static_cast<int32_t>(normals.size());
+        int32_t texCoordBase = static_cast<int32_t>(texCoords.size());
+        for (const Corner& corner : chunk.corners) {
+            Corner resolved = corner;
+            resolved.position += (corner.relative & RELATIVE_POSITION) ? positionBase : 0;
+            resolved.texCoord += (corner.relative & RELATIVE_TEXCOORD) ? texCoordBase : 0;
+            resolved.normal += (corner.relative & RELATIVE_NORMAL) ? normalBase : 0;
+            resolved.relative = 0;
+            corners.push_back(resolved);
+        }
+        for (MaterialSwitch& material : chunk.materials) {
+            material.face += faceSizes.size();
+            materials.push_back(std::move(material));
+        }
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        faceSizes.insert(faceSizes.end(), chunk.faceSizes.begin(), chunk.faceSizes.end());
+        libraries.insert(libraries.end(), chunk.libraries.begin(), chunk.libraries.end());
+        chunk = Chunk();
+    }
+
+    bool missingNormals = false;
+    for (const Corner& corner : corners) {
+        if (corner.position < 0 || corner.position >= static_cast<int32_t>(positions.size())
+            || (corner.texCoord != NO_INDEX && (corner.texCoord < 0 || corner.texCoord >= static_cast<int32_t>(texCoords.size())))
+            || (corner.normal != NO_INDEX && (corner.normal < 0 || corner.normal >= static_cast<int32_t>(normals.size())))) {
+            std::cerr << "OBJ: index out of range in " << path << std::endl;
+            return false;
+        }
+        missingNormals = missingNormals || corner.normal == NO_INDEX;
+    }
+
+    // Triangulacja wachlarzem i podział na siatki według materiału
+    std::vector<std::string> meshMaterials;
+    std::vector<std::vector<Corner>> meshCorners;
+    std::unordered_map<std::string, size_t> meshOfMaterial;
+    size_t currentMesh = SIZE_MAX;
+    size_t nextSwitch = 0;
+    size_t firstCorner = 0;
+    for (size_t face = 0; face < faceSizes.size(); ++face) {
+        while (nextSwitch < materials.size() && materials[nextSwitch].face <= face) {
+            const std::string& name = materials[nextSwitch++].name;
+            auto inserted = meshOfMaterial.emplace(name, meshMaterials.size());
+            if (inserted.second) {
+                meshMaterials.push_back(name);
+                meshCorners.emplace_back();
+            }
+            currentMesh = inserted.first->second;
+        }
+        if (currentMesh == SIZE_MAX) {
+            meshOfMaterial.emplace("", meshMaterials.size());
+            currentMesh = meshMaterials.size();
+            meshMaterials.push_back("");
+            meshCorners.emplace_back();
+        }
+        std::vector<Corner>& target = meshCorners[currentMesh];
+        for (uint32_t k = 1; k + 1 < faceSizes[face]; ++k) {
+            target.push_back(corners[firstCorner]);
+            target.push_back(corners[firstCorner + k]);
+            target.push_back(corners[firstCorner + k + 1]);
+        }
+        firstCorner += faceSizes[face];
+    }
+
+    // Normalne wygładzone po pozycji dla narożników, które ich nie mają
+    if (missingNormals && (importFlags & (aiProcess_GenSmoothNormals | aiProcess_GenNormals))) {
+        int32_t generatedBase = static_cast<int32_t>(normals.size());
+        normals.resize(normals.size() + positions.size(), glm::vec3(0.0f));
+        for (std::vector<Corner>& triangles : meshCorners) {
+            for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+                const glm::vec3& a = positions[triangles[i].position];
+                glm::vec3 normal = glm::cross(positions[triangles[i + 1].position] - a, positions[triangles[i + 2].position] - a);
+                for (int k = 0; k < 3; ++k) {
+                    if (triangles[i + k].normal == NO_INDEX) {
+                        normals[generatedBase + triangles[i + k].position] += normal;
+                    }
+                }
+            }
+        }
+        for (size_t i = generatedBase; i < normals.size(); ++i) {
+            float length = glm::length(normals[i]);
+            if (length > 0.0f) {
+                normals[i] /= length;
+            }
+        }
+        for (std::vector<Corner>& triangles : meshCorners) {
+            for (Corner& corner : triangles) {
+                if (corner.normal == NO_INDEX) {
+                    corner.normal = generatedBase + corner.position;
+                }
+            }
+        }
+    }
+
+    std::unordered_map<std::string, std::string> textures;
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    for (const std::string& library : libraries) {
+        parseMaterialLibrary((directory / library).string(), textures);
+    }
+
+    out.meshes.clear();
+    for (size_t m = 0; m < meshCorners.size(); ++m) {
+        if (meshCorners[m].empty()) {
+            continue;
+        }
+        CpuMesh mesh;
+        unsigned int workers = static_cast<unsigned int>(std::max<size_t>(1,
+            std::min<size_t>(threadCount, meshCorners[m].size() / (MIN_CHUNK_BYTES / 16))));
+        buildVertices(meshCorners[m], positions, normals, texCoords, workers, mesh);
+
+        auto texture = textures.find(meshMaterials[m]);
+        if (texture != textures.end() && !texture->second.empty()) {
+            mesh.texturePath = "models/" + texture->second;
+        }
+        out.meshes.push_back(std::move(mesh));
+    }
+    return !out.meshes.empty();
+}
@@ -86,7 +86,7 @@ void Observer::updateTarget() {
     target = position + glm::normalize(direction);
 }
 
-void Observer::applyMovementInput(const std::set<char>& keys, float deltaTime, const std::vector<Wall*>& world) {
+void Observer::applyMovementInput(const std::set<char>& keys, float deltaTime, const std::vector<CollisionBox>& world) {
     glm::vec3 forward = glm::normalize(target - position);
     forward.y = 0.0f;
     glm::vec3 right = glm::normalize(glm::cross(forward, up));
@@ -110,10 +110,10 @@ void Observer::applyMovementInput(const std::set<char>& keys, float deltaTime, c
         dir = glm::vec3(0.0f);
 
     bool collision = false;
-    for (const auto& wall : world) {
+    for (const CollisionBox& box : world) {
         float dist;
-        glm::vec3 min = wall->getMinBounds();
-        glm::vec3 max = wall->getMaxBounds();
+        const glm::vec3& min = box.min;
+        const glm::vec3& max = box.max;
 
         if (rayIntersectsAABB(position, dir, min, max, dist)) {
             if (dist > 0.01f && dist < glm::length(proposedMove) + 0.05f) {
@@ -135,7 +135,7 @@ void Observer::applyMovementInput(const std::set<char>& keys, float deltaTime, c
 }
 
 
-void Observer::updatePhysics(float deltaTime, const std::vector<Wall*>& world) {
+void Observer::updatePhysics(float deltaTime, const std::vector<CollisionBox>& world) {
     float heightOffset = 1.8f; 
     velocity.y -= 9.81f * deltaTime;
     glm::vec3 nextPos = position + velocity * deltaTime;
@@ -146,10 +146,10 @@ void Observer::updatePhysics(float deltaTime, const std::vector<Wall*>& world) {
     glm::vec3 rayDir = glm::vec3(0.0f, -1.0f, 0.0f);
     float maxDist = 0.25f;
 
-    for (const auto& wall : world) {
+    for (const CollisionBox& box : world) {
         float hitDist;
-        glm::vec3 min = wall->getMinBounds();
-        glm::vec3 max = wall->getMaxBounds();
+        const glm::vec3& min = box.min;
+        const glm::vec3& max = box.max;
 
         bool hit = rayIntersectsAABB(rayOrigin, rayDir, min, max, hitDist);
         if (hit && hitDist <= maxDist && hitDist >= -0.01f) {
@@ -0,0 +1,92 @@
+#include "PackedVertex.h"
+#include "MeshCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+VertexQuantization VertexQuantization::fromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    VertexQuantization quantization;
+    quantization.offset = boundsMin;
+    quantization.scale = boundsMax - boundsMin;
+    return quantization;
+}
+
+glm::mat4 VertexQuantization::apply(const glm::mat4& model) const {
+    glm::mat4 result = model;
+    result[0] *= scale.x;
+    result[1] *= scale.y;
+    result[2] *= scale.z;
+    result[3] = model * glm::vec4(offset, 1.0f);
+    return result;
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3& normal) {
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+    glm::vec2 p(normal.x / length, normal.y / length);
+    if (normal.z < 0.0f) {
+        // Dolna półkula odbijana jest na narożniki kwadratu
+        glm::vec2 folded(1.0f - std::abs(p.y), 1.0f - std::abs(p.x));
+        p.x = p.x >= 0.0f ? folded.x : -folded.x;
+        p.y = p.y >= 0.0f ? folded.y : -folded.y;
+    }
+    return p;
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        // Nieskończoność lub NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        // Liczba zdenormalizowana
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1u) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    // Zaokrąglenie do najbliższej; przeniesienie do wykładnika jest poprawne
+    if (mantissa & 0x1000u) {
+        ++half;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+PackedVertex packVertex(const MeshVertex& vertex, const VertexQuantization& quantization) {
+    PackedVertex packed;
+    for (int axis = 0; axis < 3; ++axis) {
+        float extent = quantization.scale[axis];
+        float t = extent > 0.0f ? (vertex.position[axis] - quantization.offset[axis]) / extent : 0.0f;
+        packed.position[axis] = static_cast<uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f));
+    }
+    packed.position[3] = 0;
+
+    glm::vec2 octahedral = encodeOctahedral(vertex.normal);
+    for (int axis = 0; axis < 2; ++axis) {
+        packed.normal[axis] = static_cast<int16_t>(std::lround(std::min(std::max(octahedral[axis], -1.0f), 1.0f) * 32767.0f));
+    }
+
+    packed.texCoord[0] = floatToHalf(vertex.texCoord.x);
+    packed.texCoord[1] = floatToHalf(vertex.texCoord.y);
+    return packed;
+}
@@ -0,0 +1,109 @@
+#include "PixelUploadRing.h"
+#include <cstring>
+
+namespace {
+    // Wyrównanie zakresów - wystarcza dla GL_UNPACK_ALIGNMENT i szybkiego memcpy
+    constexpr size_t RING_ALIGNMENT = 64;
+}
+
+PixelUploadRing::PixelUploadRing(size_t capacity)
+    : capacity(capacity) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    if (GLEW_ARB_buffer_storage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, capacity, nullptr, flags);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, capacity, flags));
+    }
+    else {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+PixelUploadRing::~PixelUploadRing() {
+    for (const Region& region : regions) {
+        glClientWaitSync(region.sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(region.sync);
+    }
+    if (mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+bool PixelUploadRing::write(const void* data, size_t size, size_t& offset) {
+    size_t aligned = (size + RING_ALIGNMENT - 1) & ~(RING_ALIGNMENT - 1);
+    if (aligned > capacity || used == capacity) {
+        return false;
+    }
+    if (used == 0) {
+        tail = 0;
+    }
+
+    size_t head = (tail + used) % capacity;
+    size_t skipped = 0;
+    if (head >= tail) {
+        // Wolne są koniec bufora i początek przed tail
+        if (capacity - head >= aligned) {
+            offset = head;
+        }
+        else if (tail >= aligned) {
+            skipped = capacity - head;
+            offset = 0;
+        }
+        else {
+            return false;
+        }
+    }
+    else if (tail - head >= aligned) {
+        offset = head;
+    }
+    else {
+        return false;
+    }
+
+    if (mapped) {
+        std::memcpy(mapped + offset, data, size);
+    }
+    else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        void* target = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (!target) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+        std::memcpy(target, data, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    used += skipped + aligned;
+    unfenced += skipped + aligned;
+    return true;
+}
+
+void PixelUploadRing::fence() {
+    if (unfenced == 0) {
+        return;
+    }
+    regions.push_back({ unfenced, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    unfenced = 0;
+}
+
+void PixelUploadRing::reclaim() {
+    while (!regions.empty()) {
+        const Region& region = regions.front();
+        GLenum status = glClientWaitSync(region.sync, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(region.sync);
+        tail = (tail + region.bytes) % capacity;
+        used -= region.bytes;
+        regions.pop_front();
+    }
+}
@@ -0,0 +1,117 @@
+#include "ProgramBinaryCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr uint32_t CACHE_MAGIC = 0x31425047; // "GPB1"
+    constexpr const char* CACHE_DIRECTORY = "shader_cache";
+
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * @struct CacheHeader
+     * @brief Nagłówek pliku wpisu; za nim następuje binarium programu.
+     */
+    struct CacheHeader {
+        uint32_t magic;    /**< CACHE_MAGIC. */
+        uint32_t format;   /**< Format binarium zwrócony przez sterownik. */
+        uint64_t key;      /**< Klucz wpisu (chroni przed kolizją nazw plików). */
+        uint64_t length;   /**< Długość binarium w bajtach. */
+    };
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(uint64_t hash, const char* text) {
+        // Długość wraz z terminatorem oddziela kolejne napisy ("ab"+"c" != "a"+"bc")
+        return text ? hashBytes(hash, text, std::char_traits<char>::length(text) + 1) : hashBytes(hash, "", 1);
+    }
+}
+
+bool ProgramBinaryCache::isSupported() {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t ProgramBinaryCache::makeKey(const std::vector<std::string>& sources) {
+    uint64_t hash = FNV_OFFSET;
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash = hashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    for (const std::string& source : sources) {
+        hash = hashString(hash, source.c_str());
+    }
+    return hash;
+}
+
+std::string ProgramBinaryCache::pathFor(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return std::string(CACHE_DIRECTORY) + "/" + name;
+}
+
+bool ProgramBinaryCache::load(GLuint program, uint64_t key) {
+    std::ifstream file(pathFor(key), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || header.magic != CACHE_MAGIC || header.key != key || header.length == 0) {
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) {
+        return false;
+    }
+
+    // Sterownik sam odrzuca binaria z innej wersji - wtedy status linkowania jest GL_FALSE
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success == GL_TRUE;
+}
+
+void ProgramBinaryCache::store(GLuint program, uint64_t key) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    std::error_code ec;
+    std::filesystem::create_directories(CACHE_DIRECTORY, ec);
+    std::string path = pathFor(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write program binary cache: " << temporary << std::endl;
+            return;
+        }
+        CacheHeader header{ CACHE_MAGIC, format, key, static_cast<uint64_t>(length) };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            std::cerr << "Failed to write program binary cache: " << temporary << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+    }
+}
@@ -0,0 +1,259 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+    enum CullMode : uint64_t {
+        CullBack = 0,
+        CullFront = 1,
+        CullNone = 2
+    };
+
+    constexpr int PASS_SHIFT = 62;
+    constexpr int CULL_SHIFT = 60;
+    constexpr int PROGRAM_SHIFT = 52;
+    constexpr int TEXTURE_SHIFT = 40;
+    constexpr int VAO_SHIFT = 24;
+    constexpr uint64_t DEPTH_MAX = (1u << 24) - 1;
+
+    bool sameDraw(const DrawPacket& a, const DrawPacket& b) {
+        return a.shader == b.shader && a.vao == b.vao && a.texture == b.texture
+            && a.indexCount == b.indexCount && a.indexType == b.indexType
+            && a.indexOffset == b.indexOffset && a.doubleSided == b.doubleSided;
+    }
+
+    CullMode cullModeFor(RenderPass pass, bool doubleSided) {
+        if (doubleSided) {
+            return CullNone;
+        }
+        // W mapach cieni odrzucamy przednie ściany, co ogranicza "shadow acne"
+        return isShadowPass(pass) ? CullFront : CullBack;
+    }
+}
+
+InstanceData makeInstanceData(const glm::mat4& model) {
+    InstanceData data;
+    data.model = model;
+
+    glm::mat3 linear(model);
+    float xx = glm::dot(linear[0], linear[0]);
+    float yy = glm::dot(linear[1], linear[1]);
+    float zz = glm::dot(linear[2], linear[2]);
+    float tolerance = 1e-4f * std::max(xx, std::max(yy, zz));
+    bool uniformScale = std::abs(xx - yy) <= tolerance && std::abs(xx - zz) <= tolerance
+        && std::abs(glm::dot(linear[0], linear[1])) <= tolerance
+        && std::abs(glm::dot(linear[0], linear[2])) <= tolerance
+        && std::abs(glm::dot(linear[1], linear[2])) <= tolerance;
+
+    glm::mat3 normalMatrix = uniformScale ? linear : glm::transpose(glm::inverse(linear));
+    for (int column = 0; column < 3; ++column) {
+        data.normalMatrix[column] = glm::vec4(normalMatrix[column], 0.0f);
+    }
+    return data;
+}
+
+InstanceData makeInstanceData(const glm::mat4& model, const VertexQuantization& quantization) {
+    InstanceData data = makeInstanceData(model);
+    data.model = quantization.apply(model);
+    return data;
+}
+
+RenderQueue::~RenderQueue() {
+    if (instanceBuffer) {
+        glDeleteBuffers(1, &instanceBuffer);
+    }
+}
+
+void RenderQueue::setupInstanceAttributes() {
+    for (GLuint column = 0; column < 4; ++column) {
+        GLuint location = INSTANCE_ATTRIBUTE_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, column * sizeof(glm::vec4));
+        glVertexAttribBinding(location, INSTANCE_BUFFER_BINDING);
+    }
+    for (GLuint column = 0; column < 3; ++column) {
+        GLuint location = INSTANCE_NORMAL_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribFormat(location, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec4));
+        glVertexAttribBinding(location, INSTANCE_BUFFER_BINDING);
+    }
+    glVertexBindingDivisor(INSTANCE_BUFFER_BINDING, 1);
+}
+
+void RenderQueue::clear() {
+    packets.clear();
+    items.clear();
+    batches.clear();
+    instances.clear();
+    untexturedVariants.clear();
+}
+
+void RenderQueue::setViewPoint(const glm::vec3& position, float farPlane) {
+    viewPosition = position;
+    depthScale = farPlane > 0.0f ? DEPTH_MAX / farPlane : 1.0f;
+}
+
+void RenderQueue::setLodProjection(float pixelsPerUnit) {
+    lodProjection = pixelsPerUnit;
+}
+
+void RenderQueue::setDefaultTexture(GLuint textureID) {
+    defaultTexture = textureID;
+}
+
+void RenderQueue::setUntexturedVariant(const Shader& shader, const Shader& untextured) {
+    untexturedVariants.push_back({ &shader, &untextured });
+}
+
+void RenderQueue::submit(RenderPass pass, const DrawPacket& packet, const glm::vec3& worldCenter) {
+    packets.push_back(packet);
+    DrawPacket& stored = packets.back();
+    if (stored.texture == 0) {
+        for (const auto& variant : untexturedVariants) {
+            if (variant.first == stored.shader) {
+                stored.shader = variant.second;
+                break;
+            }
+        }
+    }
+    items.push_back({ makeKey(pass, stored, worldCenter), static_cast<uint32_t>(packets.size() - 1) });
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, const DrawPacket& packet, const glm::vec3& worldCenter) const {
+    uint64_t depth = 0;
+    if (pass == RenderPass::Main) {
+        float distance = glm::length(worldCenter - viewPosition) * depthScale;
+        depth = static_cast<uint64_t>(std::min(distance, static_cast<float>(DEPTH_MAX)));
+    }
+    GLuint texture = packet.texture != 0 ? packet.texture : defaultTexture;
+
+    return (static_cast<uint64_t>(pass) << PASS_SHIFT)
+        | (static_cast<uint64_t>(cullModeFor(pass, packet.doubleSided)) << CULL_SHIFT)
+        | (static_cast<uint64_t>(packet.shader->getProgramID() & 0xFF) << PROGRAM_SHIFT)
+        | (static_cast<uint64_t>(texture & 0xFFF) << TEXTURE_SHIFT)
+        | (static_cast<uint64_t>(packet.vao & 0xFFFF) << VAO_SHIFT)
+        | depth;
+}
+
+void RenderQueue::sort() {
+    scratch.resize(items.size());
+
+    // Sortowanie pozycyjne LSD po 8 bitów; bajty identyczne dla wszystkich kluczy są pomijane
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const SortItem& item : items) {
+            counts[(item.key >> shift) & 0xFF]++;
+        }
+        if (counts[(items.empty() ? 0 : items[0].key >> shift) & 0xFF] == items.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t c = count;
+            count = offset;
+            offset += c;
+        }
+        for (const SortItem& item : items) {
+            scratch[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+
+    // Łączenie sąsiednich pakietów z tą samą siatką i stanem w partie instancji
+    batches.clear();
+    instances.clear();
+    for (const SortItem& item : items) {
+        const DrawPacket& packet = packets[item.index];
+        RenderPass pass = static_cast<RenderPass>(item.key >> PASS_SHIFT);
+        if (!batches.empty()) {
+            Batch& last = batches.back();
+            if (last.pass == pass && sameDraw(packets[last.packetIndex], packet)) {
+                last.instanceCount++;
+                instances.push_back(makeInstanceData(packet.model, packet.quantization));
+                continue;
+            }
+        }
+        Batch batch;
+        batch.pass = pass;
+        batch.cull = static_cast<uint32_t>((item.key >> CULL_SHIFT) & 0x3);
+        batch.packetIndex = item.index;
+        batch.baseInstance = static_cast<GLuint>(instances.size());
+        batch.instanceCount = 1;
+        batches.push_back(batch);
+        instances.push_back(makeInstanceData(packet.model, packet.quantization));
+    }
+
+    if (instances.empty()) {
+        return;
+    }
+    if (!instanceBuffer) {
+        glGenBuffers(1, &instanceBuffer);
+    }
+    GLsizeiptr size = instances.size() * sizeof(InstanceData);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if (size > instanceCapacity) {
+        instanceCapacity = size * 2;
+    }
+    // Osierocenie bufora - sterownik nie musi czekać na rysowanie z poprzedniej klatki
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderQueue::execute(RenderPass pass) {
+    auto begin = std::lower_bound(batches.begin(), batches.end(), pass,
+        [](const Batch& batch, RenderPass value) { return batch.pass < value; });
+    auto end = std::upper_bound(begin, batches.end(), pass,
+        [](RenderPass value, const Batch& batch) { return value < batch.pass; });
+    if (begin == end) {
+        return;
+    }
+
+    // Stan spoza kolejki jest nieznany, więc pierwsza partia zawsze wiąże wszystko
+    GLuint boundProgram = 0;
+    GLuint boundTexture = 0;
+    GLuint boundVAO = 0;
+    uint32_t boundCull = ~0u;
+    bool first = true;
+
+    glActiveTexture(GL_TEXTURE0);
+    for (auto it = begin; it != end; ++it) {
+        const DrawPacket& packet = packets[it->packetIndex];
+        GLuint program = packet.shader->getProgramID();
+        GLuint texture = packet.texture != 0 ? packet.texture : defaultTexture;
+
+        if (first || it->cull != boundCull) {
+            if (it->cull == CullNone) {
+                glDisable(GL_CULL_FACE);
+            }
+            else {
+                glEnable(GL_CULL_FACE);
+                glCullFace(it->cull == CullFront ? GL_FRONT : GL_BACK);
+            }
+            boundCull = it->cull;
+        }
+        if (first || program != boundProgram) {
+            glUseProgram(program);
+            boundProgram = program;
+        }
+        if (first || texture != boundTexture) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            boundTexture = texture;
+        }
+        if (first || packet.vao != boundVAO) {
+            glBindVertexArray(packet.vao);
+            glBindVertexBuffer(INSTANCE_BUFFER_BINDING, instanceBuffer, 0, sizeof(InstanceData));
+            boundVAO = packet.vao;
+        }
+        first = false;
+
+        glDrawElementsInstancedBaseInstance(GL_TRIANGLES, packet.indexCount, packet.indexType,
+            reinterpret_cast<const void*>(packet.indexOffset), it->instanceCount, it->baseInstance);
+    }
+
+    glBindVertexArray(0);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+}
@@ -1,43 +1,95 @@
 #include "Shader.h"
+#include "ProgramBinaryCache.h"
+#include <algorithm>
+#include <glm/gtc/type_ptr.hpp>
+
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines,
+    ShaderBuild mode) {
+    buildProgram({
+        { GL_VERTEX_SHADER, injectDefines(loadShaderFromFile(vertexPath), defines) },
+        { GL_FRAGMENT_SHADER, injectDefines(loadShaderFromFile(fragmentPath), defines) },
+    });
+    if (mode == ShaderBuild::Immediate) {
+        finishBuild();
+    }
+}
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-    std::string vertexCode = loadShaderFromFile(vertexPath);
-    std::string fragmentCode = loadShaderFromFile(fragmentPath);
-
-    GLuint vertexShader = compileShader(vertexCode, GL_VERTEX_SHADER);
-    GLuint fragmentShader = compileShader(fragmentCode, GL_FRAGMENT_SHADER);
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath,
+    const ShaderDefines& defines, ShaderBuild mode) {
+    buildProgram({
+        { GL_VERTEX_SHADER, injectDefines(loadShaderFromFile(vertexPath), defines) },
+        { GL_FRAGMENT_SHADER, injectDefines(loadShaderFromFile(fragmentPath), defines) },
+        { GL_GEOMETRY_SHADER, injectDefines(loadShaderFromFile(geometryPath), defines) },
+    });
+    if (mode == ShaderBuild::Immediate) {
+        finishBuild();
+    }
+}
 
+void Shader::buildProgram(const std::vector<std::pair<GLenum, std::string>>& stages) {
     programID = glCreateProgram();
-    glAttachShader(programID, vertexShader);
-    glAttachShader(programID, fragmentShader);
-    glLinkProgram(programID);
 
-    GLint success;
-    glGetProgramiv(programID, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(programID, 512, nullptr, infoLog);
-        std::cerr << "Shader Program Linking Error:\n" << infoLog << std::endl;
+    bool useCache = ProgramBinaryCache::isSupported();
+    uint64_t cacheKey = 0;
+    if (useCache) {
+        std::vector<std::string> sources;
+        for (const auto& stage : stages) {
+            sources.push_back(stage.second);
+        }
+        cacheKey = ProgramBinaryCache::makeKey(sources);
+        if (ProgramBinaryCache::load(programID, cacheKey)) {
+            reflectUniforms();
+            ready = true;
+            return;
+        }
+        // Odrzucone binarium mogło zostawić program w nieokreślonym stanie - zaczynamy od nowa
+        glDeleteProgram(programID);
+        programID = glCreateProgram();
+        glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Bez odpytywania statusu - sterownik może kompilować i linkować w tle
+    for (const auto& stage : stages) {
+        GLuint shader = compileShader(stage.second, stage.first);
+        glAttachShader(programID, shader);
+        pendingStages.push_back(shader);
+    }
+    glLinkProgram(programID);
+    storeInCache = useCache;
+    this->cacheKey = cacheKey;
+    ready = false;
 }
 
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath) {
-    std::string vertexCode = loadShaderFromFile(vertexPath);
-    std::string fragmentCode = loadShaderFromFile(fragmentPath);
-    std::string geometryCode = loadShaderFromFile(geometryPath);
-
-    GLuint vertexShader = compileShader(vertexCode, GL_VERTEX_SHADER);
-    GLuint fragmentShader = compileShader(fragmentCode, GL_FRAGMENT_SHADER);
-    GLuint geometryShader = compileShader(geometryCode, GL_GEOMETRY_SHADER);
+bool Shader::pollCompletion() {
+    if (ready) {
+        return true;
+    }
+    if (GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile) {
+        GLint complete = GL_FALSE;
+        glGetProgramiv(programID, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) {
+            return false;
+        }
+    }
+    finishBuild();
+    return true;
+}
 
-    programID = glCreateProgram();
-    glAttachShader(programID, vertexShader);
-    glAttachShader(programID, fragmentShader);
-    glAttachShader(programID, geometryShader);
-    glLinkProgram(programID);
+void Shader::finishBuild() {
+    if (ready) {
+        return;
+    }
+    ready = true;
+
+    for (GLuint shader : pendingStages) {
+        GLint success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::cerr << "Shader Compilation Error:\n" << infoLog << std::endl;
+        }
+    }
 
     GLint success;
     glGetProgramiv(programID, GL_LINK_STATUS, &success);
@@ -46,10 +98,40 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, c
         glGetProgramInfoLog(programID, 512, nullptr, infoLog);
         std::cerr << "Shader Program Linking Error:\n" << infoLog << std::endl;
     }
+    else if (storeInCache) {
+        ProgramBinaryCache::store(programID, cacheKey);
+    }
+    reflectUniforms();
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    glDeleteShader(geometryShader);
+    for (GLuint shader : pendingStages) {
+        glDetachShader(programID, shader);
+        glDeleteShader(shader);
+    }
+    pendingStages.clear();
+}
+
+std::string Shader::injectDefines(const std::string& source, const ShaderDefines& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+    size_t version = source.find("#version");
+    size_t insertAt = version == std::string::npos ? 0 : source.find('\n', version);
+    if (insertAt == std::string::npos) {
+        insertAt = source.size();
+    }
+    else if (version != std::string::npos) {
+        insertAt++;
+    }
+
+    // Numer linii za wstawionymi definicjami, liczony od 1
+    size_t nextLine = std::count(source.begin(), source.begin() + insertAt, '\n') + 1;
+
+    std::string block;
+    for (const auto& define : defines) {
+        block += "#define " + define.first + " " + std::to_string(define.second) + "\n";
+    }
+    block += "#line " + std::to_string(nextLine) + "\n";
+    return source.substr(0, insertAt) + block + source.substr(insertAt);
 }
 
 Shader::~Shader() {
@@ -64,6 +146,78 @@ GLuint Shader::getProgramID() const {
     return programID;
 }
 
+void Shader::reflectUniforms() {
+    uniforms.clear();
+
+    GLint count = 0;
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+    const GLenum props[] = { GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX };
+    std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+
+    for (GLint i = 0; i < count; ++i) {
+        GLint values[4];
+        glGetProgramResourceiv(programID, GL_UNIFORM, i, 4, props, 4, nullptr, values);
+        GLenum type = values[0];
+        GLint arraySize = values[1];
+        GLint location = values[2];
+        // Uniformy z bloków (UBO) nie mają lokalizacji
+        if (location < 0 || values[3] != -1) {
+            continue;
+        }
+
+        GLsizei length = 0;
+        glGetProgramResourceName(programID, GL_UNIFORM, i, (GLsizei)nameBuffer.size(), &length, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        // Tablice raportowane są jako "nazwa[0]" - rozwijamy wszystkie elementy
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            std::string base = name.substr(0, name.size() - 3);
+            uniforms.push_back({ base, location, type });
+            for (GLint element = 0; element < arraySize; ++element) {
+                uniforms.push_back({ base + "[" + std::to_string(element) + "]", location + element, type });
+            }
+        }
+        else {
+            uniforms.push_back({ name, location, type });
+        }
+    }
+
+    std::sort(uniforms.begin(), uniforms.end(),
+        [](const UniformInfo& a, const UniformInfo& b) { return a.name < b.name; });
+}
+
+Shader::UniformHandle Shader::getUniform(const std::string& name) const {
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name,
+        [](const UniformInfo& info, const std::string& key) { return info.name < key; });
+    if (it == uniforms.end() || it->name != name) {
+        return -1;
+    }
+    return it->location;
+}
+
+void Shader::setInt(UniformHandle handle, int value) const {
+    glProgramUniform1i(programID, handle, value);
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const {
+    glProgramUniform1f(programID, handle, value);
+}
+
+void Shader::setVec2(UniformHandle handle, const glm::vec2& value) const {
+    glProgramUniform2fv(programID, handle, 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3& value) const {
+    glProgramUniform3fv(programID, handle, 1, glm::value_ptr(value));
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4& value) const {
+    glProgramUniformMatrix4fv(programID, handle, 1, GL_FALSE, glm::value_ptr(value));
+}
+
 std::string Shader::loadShaderFromFile(const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
@@ -80,14 +234,5 @@ GLuint Shader::compileShader(const std::string& source, GLenum type) {
     const char* src = source.c_str();
     glShaderSource(shader, 1, &src, nullptr);
     glCompileShader(shader);
-
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-        std::cerr << "Shader Compilation Error:\n" << infoLog << std::endl;
-    }
-
     return shader;
 }
\ No newline at end of file
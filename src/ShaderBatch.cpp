@@ -0,0 +1,44 @@
+#include "ShaderBatch.h"
+#include <algorithm>
+
+ShaderBatch::ShaderBatch() {
+    // 0xFFFFFFFF = tyle wątków, ile sterownik uzna za sensowne
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+}
+
+Shader* ShaderBatch::add(const std::string& vertexPath, const std::string& fragmentPath, const ShaderDefines& defines) {
+    Shader* shader = new Shader(vertexPath, fragmentPath, defines, ShaderBuild::Deferred);
+    track(*shader);
+    return shader;
+}
+
+Shader* ShaderBatch::add(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath,
+    const ShaderDefines& defines) {
+    Shader* shader = new Shader(vertexPath, fragmentPath, geometryPath, defines, ShaderBuild::Deferred);
+    track(*shader);
+    return shader;
+}
+
+void ShaderBatch::track(Shader& shader) {
+    if (!shader.isReady()) {
+        pending.push_back(&shader);
+    }
+}
+
+bool ShaderBatch::poll() {
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+        [](Shader* shader) { return shader->pollCompletion(); }), pending.end());
+    return pending.empty();
+}
+
+void ShaderBatch::wait() {
+    for (Shader* shader : pending) {
+        shader->finishBuild();
+    }
+    pending.clear();
+}
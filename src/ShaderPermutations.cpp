@@ -0,0 +1,37 @@
+#include "ShaderPermutations.h"
+
+ShaderPermutations::ShaderPermutations(const std::string& vertexPath, const std::string& fragmentPath)
+    : vertexPath(vertexPath), fragmentPath(fragmentPath) {
+}
+
+std::string ShaderPermutations::makeKey(const ShaderDefines& defines) {
+    std::string key;
+    for (const auto& define : defines) {
+        key += define.first + "=" + std::to_string(define.second) + ";";
+    }
+    return key;
+}
+
+const Shader& ShaderPermutations::get(const ShaderDefines& defines) {
+    std::string key = makeKey(defines);
+    auto it = programs.find(key);
+    if (it != programs.end()) {
+        it->second->finishBuild();
+        return *it->second;
+    }
+
+    std::unique_ptr<Shader>& program = programs[key];
+    program = std::make_unique<Shader>(vertexPath, fragmentPath, defines);
+    return *program;
+}
+
+void ShaderPermutations::request(const ShaderDefines& defines, ShaderBatch& batch) {
+    std::string key = makeKey(defines);
+    if (programs.count(key)) {
+        return;
+    }
+
+    std::unique_ptr<Shader>& program = programs[key];
+    program = std::make_unique<Shader>(vertexPath, fragmentPath, defines, ShaderBuild::Deferred);
+    batch.track(*program);
+}
@@ -0,0 +1,321 @@
+#include "StaticGeometry.h"
+#include "ModelObject.h"
+#include <algorithm>
+#include <numeric>
+
+StaticGeometry::~StaticGeometry() {
+    releaseBuffers();
+}
+
+void StaticGeometry::releaseBuffers() {
+    if (vao) glDeleteVertexArrays(1, &vao);
+    if (vertexBuffer) glDeleteBuffers(1, &vertexBuffer);
+    if (indexBuffer) glDeleteBuffers(1, &indexBuffer);
+    if (drawDataBuffer) glDeleteBuffers(1, &drawDataBuffer);
+    if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+    vao = vertexBuffer = indexBuffer = drawDataBuffer = indirectBuffer = 0;
+}
+
+void StaticGeometry::clear() {
+    releaseBuffers();
+    sources.clear();
+    collisionBoxes.clear();
+    commands.clear();
+    mainCommands.clear();
+    commandBounds.clear();
+    groups.clear();
+}
+
+void StaticGeometry::setDefaultTexture(GLuint textureID) {
+    defaultTexture = textureID;
+}
+
+void StaticGeometry::addWall(const Wall& wall) {
+    collisionBoxes.push_back(wall.getCollisionBox());
+
+    // Ściany są już w przestrzeni świata, więc wszystkie z tą samą teksturą
+    // łączymy w jedną siatkę i jedno polecenie rysowania
+    Source* merged = nullptr;
+    for (Source& source : sources) {
+        if (source.vbo == 0 && source.texture == wall.getTextureID()) {
+            merged = &source;
+            break;
+        }
+    }
+    if (!merged) {
+        Source source;
+        source.texture = wall.getTextureID();
+        source.doubleSided = true;
+        sources.push_back(std::move(source));
+        merged = &sources.back();
+    }
+
+    const std::vector<float>& data = wall.getVertices();
+    GLuint base = static_cast<GLuint>(merged->vertices.size());
+    for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+        MeshVertex vertex;
+        vertex.position = glm::vec3(data[i], data[i + 1], data[i + 2]);
+        vertex.texCoord = glm::vec2(data[i + 3], data[i + 4]);
+        vertex.normal = glm::vec3(data[i + 5], data[i + 6], data[i + 7]);
+        merged->vertices.push_back(vertex);
+    }
+    for (unsigned int index : wall.getIndices()) {
+        merged->indices.push_back(base + index);
+    }
+    merged->vertexCount = static_cast<GLsizei>(merged->vertices.size());
+    merged->indexCount = static_cast<GLsizei>(merged->indices.size());
+    merged->bounds = BoundingSphere::fromVertices(&merged->vertices[0].position.x,
+        merged->vertices.size() * sizeof(MeshVertex) / sizeof(float), sizeof(MeshVertex) / sizeof(float));
+}
+
+void StaticGeometry::addModel(const ModelObject& model) {
+    const MeshHandle& asset = model.getAsset();
+    if (!asset) return;
+
+    glm::mat4 modelMatrix = model.getModelMatrix();
+    BoundingSphere bounds = model.getBoundingSphere().transformed(modelMatrix);
+    for (const GpuMesh& mesh : asset->meshes) {
+        Source source;
+        source.vbo = mesh.VBO;
+        source.ebo = mesh.EBO;
+        source.vertexCount = mesh.vertexCount;
+        source.indexCount = mesh.indexCount;
+        source.indexType = mesh.indexType;
+        source.quantization = mesh.quantization;
+        source.texture = mesh.textureID;
+        source.model = modelMatrix;
+        source.bounds = bounds;
+        sources.push_back(std::move(source));
+    }
+}
+
+void StaticGeometry::build() {
+    releaseBuffers();
+    commands.clear();
+    mainCommands.clear();
+    commandBounds.clear();
+    groups.clear();
+    if (sources.empty()) {
+        return;
+    }
+
+    // Kolejność poleceń: tryb odrzucania, potem tekstura - każda grupa to jedno wywołanie
+    std::vector<size_t> order(sources.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto textureOf = [this](const Source& s) { return s.texture != 0 ? s.texture : defaultTexture; };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const Source& sa = sources[a];
+        const Source& sb = sources[b];
+        if (sa.doubleSided != sb.doubleSided) return sa.doubleSided < sb.doubleSided;
+        return textureOf(sa) < textureOf(sb);
+    });
+
+    // Indeksy są lokalne dla siatki (baseVertex), więc 16 bitów wystarcza, jeśli każda
+    // siatka ma mniej niż 65536 wierzchołków
+    GLsizeiptr totalVertices = 0;
+    GLsizeiptr totalIndices = 0;
+    indexType = GL_UNSIGNED_SHORT;
+    for (const Source& source : sources) {
+        totalVertices += source.vertexCount;
+        totalIndices += source.indexCount;
+        if (source.vertexCount > 65536) {
+            indexType = GL_UNSIGNED_INT;
+        }
+    }
+    const GLsizeiptr indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    std::vector<uint32_t> wideIndices;
+    std::vector<uint16_t> narrowIndices;
+    std::vector<PackedVertex> packedVertices;
+
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+    const GLsizeiptr vertexSize = PACK_MESH_VERTICES ? sizeof(PackedVertex) : sizeof(MeshVertex);
+    glBufferData(GL_COPY_WRITE_BUFFER, totalVertices * vertexSize, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, totalIndices * indexSize, nullptr, GL_STATIC_DRAW);
+
+    std::vector<InstanceData> drawData;
+    drawData.reserve(sources.size());
+    commands.reserve(sources.size());
+
+    GLuint vertexOffset = 0;
+    GLuint indexOffset = 0;
+    for (size_t index : order) {
+        Source& source = sources[index];
+        GLsizeiptr vertexBytes = source.vertexCount * vertexSize;
+        GLsizeiptr indexBytes = source.indexCount * indexSize;
+
+        // Siatki modeli są już na GPU - kopiujemy je bez powrotu przez pamięć CPU
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+        if (source.vbo) {
+            glBindBuffer(GL_COPY_READ_BUFFER, source.vbo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, vertexOffset * vertexSize, vertexBytes);
+        }
+        else if (PACK_MESH_VERTICES) {
+            // Ściany pakowane są tutaj, z kwantyzacją względem własnego prostopadłościanu
+            source.quantization = MeshCache::quantizationFor(source.vertices);
+            packedVertices.clear();
+            for (const MeshVertex& vertex : source.vertices) {
+                packedVertices.push_back(packVertex(vertex, source.quantization));
+            }
+            glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * vertexSize, vertexBytes, packedVertices.data());
+        }
+        else {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * vertexSize, vertexBytes, source.vertices.data());
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+        if (source.ebo && source.indexType == indexType) {
+            glBindBuffer(GL_COPY_READ_BUFFER, source.ebo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, indexOffset * indexSize, indexBytes);
+        }
+        else if (source.ebo) {
+            // Siatka 16-bitowa w arenie 32-bitowej - poszerzenie przez pamięć CPU
+            narrowIndices.resize(source.indexCount);
+            glBindBuffer(GL_COPY_READ_BUFFER, source.ebo);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, source.indexCount * sizeof(uint16_t), narrowIndices.data());
+            wideIndices.assign(narrowIndices.begin(), narrowIndices.end());
+            glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * indexSize, indexBytes, wideIndices.data());
+        }
+        else if (indexType == GL_UNSIGNED_SHORT) {
+            narrowIndices.assign(source.indices.begin(), source.indices.end());
+            glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * indexSize, indexBytes, narrowIndices.data());
+        }
+        else {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * indexSize, indexBytes, source.indices.data());
+        }
+
+        DrawElementsIndirectCommand command;
+        command.count = static_cast<GLuint>(source.indexCount);
+        command.instanceCount = 1;
+        command.firstIndex = indexOffset;
+        command.baseVertex = static_cast<GLint>(vertexOffset);
+        command.baseInstance = static_cast<GLuint>(commands.size());
+        commands.push_back(command);
+        commandBounds.push_back(source.bounds);
+        drawData.push_back(makeInstanceData(source.model, source.quantization));
+
+        GLuint texture = textureOf(source);
+        if (groups.empty() || groups.back().doubleSided != source.doubleSided || groups.back().texture != texture) {
+            groups.push_back({ source.doubleSided, texture, static_cast<GLuint>(commands.size() - 1), 0 });
+        }
+        groups.back().count++;
+
+        vertexOffset += source.vertexCount;
+        indexOffset += source.indexCount;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glGenBuffers(1, &drawDataBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, drawDataBuffer);
+    glBufferData(GL_ARRAY_BUFFER, drawData.size() * sizeof(InstanceData), drawData.data(), GL_STATIC_DRAW);
+
+    // Pierwsza połowa: wszystkie polecenia (cienie), druga: polecenia po odrzucaniu (przebieg główny)
+    mainCommands = commands;
+    GLsizeiptr listBytes = commands.size() * sizeof(DrawElementsIndirectCommand);
+    glGenBuffers(1, &indirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, listBytes * 2, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, listBytes, commands.data());
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, listBytes, listBytes, mainCommands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+    if (PACK_MESH_VERTICES) {
+        MeshCache::setupPackedVertexAttributes();
+    }
+    else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, texCoord));
+        glEnableVertexAttribArray(1);
+
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, normal));
+        glEnableVertexAttribArray(2);
+    }
+
+    // Dane rysowania czytane atrybutem instancji: baseInstance polecenia wybiera macierz
+    RenderQueue::setupInstanceAttributes();
+    glBindVertexBuffer(INSTANCE_BUFFER_BINDING, drawDataBuffer, 0, sizeof(InstanceData));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Kopie CPU ścian nie są już potrzebne
+    sources.clear();
+}
+
+void StaticGeometry::draw(RenderPass pass, const Shader& shader, const Shader* untexturedShader) const {
+    if (!isBuilt()) {
+        return;
+    }
+
+    GLuint boundProgram = shader.getProgramID();
+    glUseProgram(boundProgram);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glActiveTexture(GL_TEXTURE0);
+
+    size_t listOffset = isShadowPass(pass) ? 0 : commands.size();
+    for (const Group& group : groups) {
+        if (group.doubleSided) {
+            glDisable(GL_CULL_FACE);
+        }
+        else {
+            glEnable(GL_CULL_FACE);
+            glCullFace(isShadowPass(pass) ? GL_FRONT : GL_BACK);
+        }
+        // Siatki bez tekstury dostały teksturę domyślną - rysujemy je wariantem bez próbkowania
+        GLuint program = untexturedShader && group.texture == defaultTexture
+            ? untexturedShader->getProgramID() : shader.getProgramID();
+        if (program != boundProgram) {
+            glUseProgram(program);
+            boundProgram = program;
+        }
+        glBindTexture(GL_TEXTURE_2D, group.texture);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType,
+            reinterpret_cast<const void*>((listOffset + group.first) * sizeof(DrawElementsIndirectCommand)),
+            group.count, 0);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+}
+
+void StaticGeometry::cull(const Frustum& frustum, CullingStats& stats) {
+    if (!isBuilt()) {
+        return;
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i < mainCommands.size(); ++i) {
+        GLuint instanceCount = frustum.isVisible(commandBounds[i]) ? 1u : 0u;
+        if (instanceCount) {
+            stats.visible++;
+        }
+        else {
+            stats.culled++;
+        }
+        if (mainCommands[i].instanceCount != instanceCount) {
+            mainCommands[i].instanceCount = instanceCount;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        GLsizeiptr listBytes = mainCommands.size() * sizeof(DrawElementsIndirectCommand);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, listBytes, listBytes, mainCommands.data());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+}
@@ -6,27 +6,14 @@
 
 TargetObject::TargetObject(const std::string& path)
     : ModelObject(path) {
-    calculateBoundingBox();
-}
-
-void TargetObject::calculateBoundingBox() {
-    bool first = true;
-    for (const Mesh& mesh : meshes) {
-        for (const Vertex& v : mesh.vertices) {
-            glm::vec3 p = v.position;
-            if (first) {
-                bboxMin = bboxMax = p;
-                first = false;
-            }
-            else {
-                bboxMin = glm::min(bboxMin, p);
-                bboxMax = glm::max(bboxMax, p);
-            }
-        }
-    }
 }
 
 bool TargetObject::isHitByRay(const glm::vec3& rayOrigin, const glm::vec3& rayDir) const {
+    // Model wczytywany w tle nie ma jeszcze prostopadłościanu otaczającego
+    if (!isLoaded()) return false;
+
+    const glm::vec3& bboxMin = asset->boundsMin;
+    const glm::vec3& bboxMax = asset->boundsMax;
     glm::vec3 a = glm::vec3(getModelMatrix() * glm::vec4(bboxMin, 1.0f));
     glm::vec3 b = glm::vec3(getModelMatrix() * glm::vec4(bboxMax, 1.0f));
     glm::vec3 min = glm::min(a, b);
@@ -0,0 +1,49 @@
+#include "UniformBuffer.h"
+#include <cstring>
+
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr blockSize, int slotCount)
+    : binding(binding), blockSize(blockSize), slotCount(slotCount) {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    slotStride = (blockSize + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &bufferID);
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    glBufferData(GL_UNIFORM_BUFFER, slotStride * slotCount, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    bindSlot(0);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &bufferID);
+}
+
+void UniformBuffer::upload(const void* blocks, int count) {
+    if (count > slotCount) {
+        count = slotCount;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    if (slotStride == blockSize) {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, blockSize * count, blocks);
+    }
+    else {
+        // Sloty muszą być wyrównane - składamy je w jeden ciągły obszar
+        staging.resize(slotStride * count);
+        for (int i = 0; i < count; ++i) {
+            std::memcpy(staging.data() + slotStride * i, static_cast<const unsigned char*>(blocks) + blockSize * i, blockSize);
+        }
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), staging.data());
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::uploadPartial(const void* data, GLsizeiptr size) {
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size < blockSize ? size : blockSize, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::bindSlot(int slot) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, bufferID, slotStride * slot, blockSize);
+}
@@ -41,28 +41,43 @@ void Wall::setupBuffers() {
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
+    RenderQueue::setupInstanceAttributes();
+
     glBindVertexArray(0);
 
 }
 
-void Wall::draw(GLuint shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection) {
-    glUseProgram(shaderProgram);
+void Wall::syncBuffers() const {
+    if (!buffersDirty) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffersDirty = false;
+}
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+void Wall::submit(RenderQueue& queue, RenderPass pass, const Shader& shader, const glm::mat4& model) const {
+    syncBuffers();
 
-    if (textureID != 0) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glUniform1i(glGetUniformLocation(shaderProgram, "texture1"), 0);
-    }
+    DrawPacket packet;
+    packet.shader = &shader;
+    packet.vao = vao;
+    packet.texture = textureID;
+    packet.indexCount = static_cast<GLsizei>(indices.size());
+    packet.doubleSided = true;
+    packet.model = model;
 
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    glm::vec3 center = (getMinBounds() + getMaxBounds()) * 0.5f;
+    queue.submit(pass, packet, glm::vec3(model * glm::vec4(center, 1.0f)));
+}
 
-    glUseProgram(0);
+BoundingSphere Wall::getBoundingSphere() const {
+    if (boundsDirty) {
+        bounds = BoundingSphere::fromVertices(vertices.data(), vertices.size(), 8);
+        boundsDirty = false;
+    }
+    return bounds;
 }
 
 void Wall::translate(const glm::vec3& direction) {
@@ -72,9 +87,8 @@ void Wall::translate(const glm::vec3& direction) {
         vertices[i + 2] += direction.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffersDirty = true;
+    boundsDirty = true;
 }
 
 void Wall::rotate(float angle, const glm::vec3& axis) {
@@ -93,9 +107,8 @@ void Wall::rotate(float angle, const glm::vec3& axis) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffersDirty = true;
+    boundsDirty = true;
 }
 
 void Wall::scale(float sx, float sy) {
@@ -120,9 +133,8 @@ void Wall::scale(float sx, float sy) {
         vertices[i + 7] = normal.z;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), vertices.data());
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    buffersDirty = true;
+    boundsDirty = true;
 }
 
 void Wall::rotatePoint(float angle, const glm::vec3& axis, const glm::vec3& point) {
@@ -0,0 +1,34 @@
+#include "CookedMesh.h"
+#include "MeshCache.h"
+#include <iostream>
+
+/**
+ * @brief Przetwarza modele do formatu CookedMesh.
+ *
+ * Użycie: MeshCooker <model> [<model> ...]. Każdy model importowany jest tak samo jak
+ * w grze (Assimp, optymalizacja, poziomy szczegółowości, pakowanie wierzchołków),
+ * a wynik zapisywany obok źródła z rozszerzeniem .mesh.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <model> [<model> ...]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string source = argv[i];
+        CpuModel model;
+        if (!MeshCache::importModel(source, MeshCache::DEFAULT_IMPORT_FLAGS, model)) {
+            ++failures;
+            continue;
+        }
+        std::string cooked = CookedMesh::pathFor(source);
+        if (!CookedMesh::write(cooked, model, MeshCache::DEFAULT_IMPORT_FLAGS)) {
+            ++failures;
+            continue;
+        }
+        std::cout << source << " -> " << cooked << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
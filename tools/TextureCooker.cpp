@@ -0,0 +1,47 @@
+#include "CookedTexture.h"
+#include "MipChain.h"
+#include <iostream>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+/**
+ * @brief Przetwarza obrazy do skompresowanych tekstur DDS.
+ *
+ * Użycie: TextureCooker <obraz> [<obraz> ...]. Każdy obraz dekodowany jest tak samo jak
+ * w grze (stb_image, odwrócenie w pionie), dostaje łańcuch mipmap i jest kompresowany
+ * do BC1 (bez alfy) lub BC3 (z alfą). Wynik zapisywany jest obok źródła z rozszerzeniem .dds.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <image> [<image> ...]" << std::endl;
+        return 1;
+    }
+
+    stbi_set_flip_vertically_on_load(true);
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string source = argv[i];
+        int width, height, channels;
+        unsigned char* data = stbi_load(source.c_str(), &width, &height, &channels, 0);
+        if (!data) {
+            std::cerr << "Failed to load texture: " << source << std::endl;
+            ++failures;
+            continue;
+        }
+        MipChain chain;
+        MipChain::build(data, width, height, channels, chain);
+        stbi_image_free(data);
+
+        std::string cooked = CookedTexture::pathFor(source);
+        if (!CookedTexture::write(cooked, chain)) {
+            ++failures;
+            continue;
+        }
+        std::cout << source << " -> " << cooked
+            << " (" << (CookedTexture::formatFor(channels) == BlockFormat::BC1 ? "BC1" : "BC3")
+            << ", " << chain.levels.size() << " mip levels)" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}